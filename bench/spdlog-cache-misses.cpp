@@ -0,0 +1,78 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+// Measure the L1 data cache read misses and time per log call (linux perf counters).
+// Falls back to timing only if the counters are not available (e.g. in containers or with perf_event_paranoid > 2).
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "spdlog/sinks/null_sink.h"
+#include "spdlog/spdlog.h"
+
+static int open_l1d_read_misses()
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+int main(int, char *[])
+{
+    using namespace std::chrono;
+    using clock = steady_clock;
+
+    int howmany = 1000000;
+
+    auto logger = spdlog::create<spdlog::sinks::null_sink_st>("null_logger");
+    logger->set_pattern("[%Y-%m-%d %T.%F]: %L %v");
+
+    // warm up
+    for (int i = 0; i < 1000; ++i)
+        logger->info("spdlog message #{} : This is some text for your pleasure", i);
+
+    int fd = open_l1d_read_misses();
+    if (fd != -1)
+    {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+
+    auto start = clock::now();
+    for (int i = 0; i < howmany; ++i)
+        logger->info("spdlog message #{} : This is some text for your pleasure", i);
+    duration<double, std::nano> delta = clock::now() - start;
+
+    long long misses = 0;
+    if (fd != -1)
+    {
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd, &misses, sizeof(misses)) != sizeof(misses))
+            misses = -1;
+        close(fd);
+    }
+
+    std::cout << "sizeof(log_msg) = " << sizeof(spdlog::details::log_msg) << " bytes" << std::endl;
+    std::cout << "Total: " << howmany << std::endl;
+    std::cout << "Time per call = " << std::fixed << delta.count() / howmany << " ns" << std::endl;
+    if (fd != -1 && misses >= 0)
+        std::cout << "L1D read misses per call = " << std::fixed << static_cast<double>(misses) / howmany << std::endl;
+    else
+        std::cout << "L1D read misses per call = n/a (perf counters not available)" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+// Multi threaded throughput through a dist_sink_mt with four child sinks, serialized or concurrent,
+// with and without another thread adding and removing a sink meanwhile.
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "spdlog/sinks/dist_sink.h"
+#include "spdlog/sinks/null_sink.h"
+#include "spdlog/spdlog.h"
+
+using namespace std;
+
+static void bench(const string &title, int thread_count, int howmany, spdlog::sinks::dist_sink_mode mode, bool mutate)
+{
+    using namespace std::chrono;
+    using clock = steady_clock;
+
+    auto dist = std::make_shared<spdlog::sinks::dist_sink_mt>(mode);
+    for (int i = 0; i < 4; i++)
+    {
+        dist->add_sink(std::make_shared<spdlog::sinks::null_sink_mt>());
+    }
+    spdlog::logger logger("dist", dist);
+
+    std::atomic<bool> done{false};
+    std::atomic<int> changes{0};
+    std::thread mutator([&]() {
+        auto extra = std::make_shared<spdlog::sinks::null_sink_mt>();
+        while (mutate && !done)
+        {
+            dist->add_sink(extra);
+            dist->remove_sink(extra);
+            changes += 2;
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    });
+
+    std::vector<thread> threads;
+    auto start = clock::now();
+    for (int t = 0; t < thread_count; ++t)
+    {
+        threads.push_back(std::thread([&]() {
+            for (int i = 0; i < howmany; i++)
+            {
+                logger.info("Hello logger: msg number {}", i);
+            }
+        }));
+    }
+
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    duration<double> delta = clock::now() - start;
+    done = true;
+    mutator.join();
+
+    auto total = static_cast<double>(howmany) * thread_count;
+    std::cout << title << std::endl;
+    std::cout << "  Rate = " << std::fixed << total / delta.count() << " msgs/sec";
+    if (mutate)
+        std::cout << ", sink list changes meanwhile = " << changes;
+    std::cout << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    int thread_count = 4;
+    if (argc > 1)
+        thread_count = std::atoi(argv[1]);
+
+    int howmany = 1000000;
+
+    std::cout << "Threads: " << thread_count << ", messages per thread: " << howmany << std::endl;
+    using spdlog::sinks::dist_sink_mode;
+    bench("dist_sink_mt, 4 sinks, serialized", thread_count, howmany, dist_sink_mode::serialized, false);
+    bench("dist_sink_mt, 4 sinks, concurrent", thread_count, howmany, dist_sink_mode::concurrent, false);
+    bench("dist_sink_mt, 4 sinks, serialized, adding and removing a sink", thread_count, howmany, dist_sink_mode::serialized, true);
+    bench("dist_sink_mt, 4 sinks, concurrent, adding and removing a sink", thread_count, howmany, dist_sink_mode::concurrent, true);
+
+    return 0;
+}
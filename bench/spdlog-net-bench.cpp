@@ -0,0 +1,162 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+// Single threaded throughput of the udp and tcp sinks to a receiver thread on the loopback interface.
+// "received" is what the receiver got: the udp sink drops messages when the receiver does not keep up.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "spdlog/sinks/tcp_sink.h"
+#include "spdlog/sinks/udp_sink.h"
+#include "spdlog/spdlog.h"
+
+using namespace std;
+
+// drain a loopback socket in a thread, counting the messages received
+class receiver
+{
+public:
+    explicit receiver(int type)
+        : _type(type)
+    {
+        _fd = ::socket(AF_INET, type, 0);
+        struct sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(_fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr));
+        socklen_t len = sizeof(addr);
+        ::getsockname(_fd, reinterpret_cast<struct sockaddr *>(&addr), &len);
+        _port = ntohs(addr.sin_port);
+        if (type == SOCK_STREAM)
+        {
+            ::listen(_fd, 1);
+        }
+        _thread = std::thread([this]() { run(); });
+    }
+
+    ~receiver()
+    {
+        _done = true;
+        _thread.join();
+        ::close(_fd);
+    }
+
+    int port() const
+    {
+        return _port;
+    }
+
+    size_t received() const
+    {
+        return _received;
+    }
+
+private:
+    void run()
+    {
+        int fd = _fd;
+        if (_type == SOCK_STREAM)
+        {
+            if (!wait_readable(fd))
+            {
+                return;
+            }
+            fd = ::accept(_fd, nullptr, nullptr);
+        }
+        char buf[64 * 1024];
+        while (wait_readable(fd))
+        {
+            auto n = ::recv(fd, buf, sizeof(buf), 0);
+            if (n <= 0)
+            {
+                break;
+            }
+            // one message per datagram, or per line
+            _received += _type == SOCK_DGRAM ? 1 : std::count(buf, buf + n, '\n');
+        }
+        if (fd != _fd)
+        {
+            ::close(fd);
+        }
+    }
+
+    bool wait_readable(int fd)
+    {
+        struct pollfd pfd;
+        pfd.fd = fd;
+        pfd.events = POLLIN;
+        while (!_done)
+        {
+            pfd.revents = 0;
+            if (::poll(&pfd, 1, 100) == 1)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    int _type;
+    int _fd;
+    int _port;
+    std::atomic<bool> _done{false};
+    std::atomic<size_t> _received{0};
+    std::thread _thread;
+};
+
+template<class Sink, class... SinkArgs>
+static void bench(const string &title, int type, int howmany, const SinkArgs &... sink_args)
+{
+    using namespace std::chrono;
+    using clock = steady_clock;
+
+    receiver r(type);
+    auto start = clock::now();
+    {
+        auto sink = std::make_shared<Sink>("127.0.0.1", r.port(), sink_args...);
+        spdlog::logger logger("net", sink);
+        for (int i = 0; i < howmany; i++)
+        {
+            logger.info("Hello logger: msg number {}", i);
+        }
+        logger.flush();
+    }
+    duration<double> delta = clock::now() - start;
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    std::cout << title << std::endl;
+    std::cout << "  Rate = " << std::fixed << howmany / delta.count() << " msgs/sec, received = " << r.received() << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    using spdlog::sinks::flush_policy;
+
+    int howmany = 200000;
+    if (argc > 1)
+        howmany = std::atoi(argv[1]);
+
+    std::cout << "Messages: " << howmany << std::endl;
+    bench<spdlog::sinks::udp_sink_st>("udp_sink, datagram per message", SOCK_DGRAM, howmany);
+    bench<spdlog::sinks::udp_sink_st>("udp_sink, batched", SOCK_DGRAM, howmany, flush_policy::every_bytes(64 * 1024));
+    bench<spdlog::sinks::tcp_sink_st>("tcp_sink, write per message", SOCK_STREAM, howmany);
+    bench<spdlog::sinks::tcp_sink_st>("tcp_sink, 64KB writes", SOCK_STREAM, howmany, flush_policy::every_bytes(64 * 1024));
+
+    return 0;
+}
@@ -0,0 +1,87 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+// Throughput of an async logger with three slow sinks (each one waits a while per message, as a network or
+// compressing sink would), with the worker passing the messages to the sinks one after the other, or in parallel
+// with sink threads. Sequential dispatch is bounded by the sum of the sinks' costs, parallel by the slowest sink.
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "spdlog/sinks/base_sink.h"
+#include "spdlog/spdlog.h"
+
+using namespace std;
+
+// a sink taking the given time per message
+class slow_sink : public spdlog::sinks::base_sink<std::mutex>
+{
+public:
+    explicit slow_sink(std::chrono::microseconds delay)
+        : _delay(delay)
+    {
+    }
+
+protected:
+    void _sink_it(const spdlog::details::log_msg &) override
+    {
+        std::this_thread::sleep_for(_delay);
+    }
+
+    void _flush() override {}
+
+private:
+    const std::chrono::microseconds _delay;
+};
+
+static void bench(const string &title, int howmany, size_t sink_threads)
+{
+    using namespace std::chrono;
+    using clock = steady_clock;
+
+    auto start = clock::now();
+    {
+        spdlog::async_logger logger("parallel",
+            {std::make_shared<slow_sink>(microseconds(20)), std::make_shared<slow_sink>(microseconds(40)),
+                std::make_shared<slow_sink>(microseconds(60))},
+            8192, spdlog::async_overflow_policy::block_retry, nullptr, milliseconds::zero(), nullptr, sink_threads);
+        for (int i = 0; i < howmany; i++)
+        {
+            logger.info("Hello logger: msg number {}", i);
+        }
+        // the destructor waits for the worker to write everything
+    }
+    duration<double> delta = clock::now() - start;
+
+    std::cout << title << std::endl;
+    std::cout << "  Rate = " << std::fixed << howmany / delta.count() << " msgs/sec" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    int howmany = 20000;
+    if (argc > 1)
+    {
+        howmany = atoi(argv[1]);
+    }
+
+    try
+    {
+        bench("sequential dispatch (3 sinks: 20us, 40us, 60us per message)", howmany, 0);
+        bench("parallel dispatch, 2 sink threads", howmany, 2);
+    }
+    catch (std::exception &ex)
+    {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        perror("Last error");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
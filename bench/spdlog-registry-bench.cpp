@@ -0,0 +1,83 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+// Concurrent logger lookups (spdlog::get and logger_handle) from many threads,
+// while another thread keeps registering and dropping loggers.
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "spdlog/sinks/null_sink.h"
+#include "spdlog/spdlog.h"
+
+using namespace std;
+
+static void bench(const string &title, int thread_count, int howmany, const function<bool()> &lookup)
+{
+    using namespace std::chrono;
+    using clock = steady_clock;
+
+    std::atomic<bool> done{false};
+    std::atomic<int> registrations{0};
+    std::thread registrar([&]() {
+        while (!done)
+        {
+            auto name = "tmp" + std::to_string(registrations++ % 16);
+            spdlog::create<spdlog::sinks::null_sink_mt>(name);
+            spdlog::drop(name);
+        }
+    });
+
+    std::atomic<int> misses{0};
+    std::vector<thread> threads;
+    auto start = clock::now();
+    for (int t = 0; t < thread_count; ++t)
+    {
+        threads.push_back(std::thread([&]() {
+            for (int i = 0; i < howmany; i++)
+            {
+                if (!lookup())
+                    ++misses;
+            }
+        }));
+    }
+
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    duration<double> delta = clock::now() - start;
+    done = true;
+    registrar.join();
+
+    auto total = static_cast<double>(howmany) * thread_count;
+    std::cout << title << std::endl;
+    std::cout << "  Rate = " << std::fixed << total / delta.count() << " lookups/sec" << std::endl;
+    std::cout << "  Registrations meanwhile = " << registrations << ", misses = " << misses << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    int thread_count = 32;
+    if (argc > 1)
+        thread_count = std::atoi(argv[1]);
+
+    int howmany = 1000000;
+
+    spdlog::create<spdlog::sinks::null_sink_mt>("net");
+    auto handle = spdlog::get_handle("net");
+
+    std::cout << "Threads: " << thread_count << ", lookups per thread: " << howmany << std::endl;
+    bench("spdlog::get(\"net\")", thread_count, howmany, [] { return spdlog::get("net") != nullptr; });
+    bench("logger_handle::get()", thread_count, howmany, [&handle] { return handle.get() != nullptr; });
+
+    return 0;
+}
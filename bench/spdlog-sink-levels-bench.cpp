@@ -0,0 +1,64 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+// Cost of passing a message to a logger's sinks when most of them filter it out by their level.
+// Usage: spdlog-sink-levels-bench [messages]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "spdlog/sinks/null_sink.h"
+#include "spdlog/spdlog.h"
+
+using namespace std;
+
+// sink_count sinks, of which only accepted accept info messages
+static void bench(size_t sink_count, size_t accepted, int howmany)
+{
+    using namespace std::chrono;
+    using clock = steady_clock;
+
+    std::vector<spdlog::sink_ptr> sinks;
+    for (size_t i = 0; i < sink_count; i++)
+    {
+        auto sink = std::make_shared<spdlog::sinks::null_sink_st>();
+        if (i >= accepted)
+        {
+            sink->set_level(spdlog::level::err);
+        }
+        sinks.push_back(sink);
+    }
+    spdlog::logger logger("levels", sinks.begin(), sinks.end());
+    logger.set_pattern("%v");
+
+    auto start = clock::now();
+    for (int i = 0; i < howmany; i++)
+    {
+        logger.info("Hello logger: msg number {}", i);
+    }
+    duration<double, std::nano> delta = clock::now() - start;
+
+    std::cout << "  " << sink_count << " sinks, " << accepted << " accepting: " << std::fixed << delta.count() / howmany
+              << " ns/msg" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    int howmany = 5000000;
+    if (argc > 1)
+        howmany = std::atoi(argv[1]);
+
+    std::cout << "Messages: " << howmany << std::endl;
+    for (size_t sink_count : {2, 8, 32, 64})
+    {
+        bench(sink_count, 1, howmany);
+        bench(sink_count, sink_count / 2, howmany);
+    }
+    return 0;
+}
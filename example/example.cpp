@@ -69,7 +69,7 @@ int main(int, char *[])
         console->debug("This message should be displayed..");
 
         // Compile time log levels
-        // define SPDLOG_DEBUG_ON or SPDLOG_TRACE_ON
+        // define SPDLOG_ACTIVE_LEVEL (or SPDLOG_DEBUG_ON / SPDLOG_TRACE_ON) to set the compile time floor
         SPDLOG_TRACE(console, "Enabled only #ifdef SPDLOG_TRACE_ON..{} ,{}", 1, 3.23);
         SPDLOG_DEBUG(console, "Enabled only #ifdef SPDLOG_DEBUG_ON.. {} ,{}", 1, 3.23);
 
@@ -0,0 +1,52 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+//
+// spdlog-decode: render binary log files (see binary_formatter.h) back to text.
+// usage: spdlog-decode <binary log file> [pattern]
+//
+#include "spdlog/binary_formatter.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: " << argv[0] << " <binary log file> [pattern]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::ifstream ifs(argv[1], std::ios::binary);
+    if (!ifs)
+    {
+        std::cerr << "Failed opening " << argv[1] << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::string data((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+
+    try
+    {
+        spdlog::pattern_formatter formatter(argc > 2 ? argv[2] : "%+");
+        spdlog::binary_reader reader(data.data(), data.size());
+        spdlog::details::log_msg msg;
+        while (reader.next(msg))
+        {
+            formatter.format(msg);
+            std::fwrite(msg.formatted.data(), 1, msg.formatted.size(), stdout);
+        }
+    }
+    catch (const spdlog::spdlog_ex &ex)
+    {
+        std::cerr << "Decode failed: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,130 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+//
+// spdlog-shm-reader: drain a shared memory ring (see shm_ring_sink.h) into a log file until interrupted.
+// usage: spdlog-shm-reader <shared memory name> <log file> [pattern for binary records]
+//
+// The ring remembers what was read: a restarted reader continues where the previous one stopped.
+//
+#include "spdlog/sinks/file_sinks.h"
+#include "spdlog/sinks/shm_ring_sink.h"
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+static std::atomic<bool> stop_requested{false};
+
+static void on_signal(int)
+{
+    stop_requested = true;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        std::cerr << "usage: " << argv[0] << " <shared memory name> <log file> [pattern for binary records]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+
+    try
+    {
+        // wait for the logging process to create the ring
+        std::unique_ptr<spdlog::details::shm_ring> ring;
+        while (!ring && !stop_requested)
+        {
+            try
+            {
+                ring.reset(new spdlog::details::shm_ring(argv[1]));
+            }
+            catch (const spdlog::spdlog_ex &)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+        }
+        if (!ring)
+        {
+            return EXIT_SUCCESS;
+        }
+
+        auto file = std::make_shared<spdlog::sinks::simple_file_sink_st>(argv[2]);
+        spdlog::pattern_formatter formatter(argc > 3 ? argv[3] : "%+");
+        spdlog::sinks::shm_ring_binary_reader binary;
+        size_t skipped = 0;
+        auto write_record = [&](spdlog::details::shm_ring::record_type type, const char *data, size_t size) {
+            if (type == spdlog::details::shm_ring::text)
+            {
+                spdlog::details::log_msg msg;
+                msg.formatted << fmt::StringRef(data, size);
+                file->log(msg);
+                return;
+            }
+            try
+            {
+                auto read = binary.read(data, size, [&](spdlog::details::log_msg &msg) {
+                    formatter.format(msg);
+                    file->log(msg);
+                });
+                if (!read)
+                {
+                    ++skipped; // an earlier record of its generation was lost
+                }
+            }
+            catch (const spdlog::spdlog_ex &ex)
+            {
+                std::cerr << "Skipping a corrupted record: " << ex.what() << std::endl;
+            }
+        };
+
+        // poll the ring, backing off up to 10ms while it is empty
+        auto dropped = ring->dropped();
+        auto idle_wait = std::chrono::milliseconds(1);
+        for (;;)
+        {
+            auto stopping = stop_requested.load();
+            if (ring->read(write_record) > 0)
+            {
+                file->flush();
+                idle_wait = std::chrono::milliseconds(1);
+            }
+            else if (!stopping)
+            {
+                std::this_thread::sleep_for(idle_wait);
+                idle_wait = std::min(idle_wait * 2, std::chrono::milliseconds(10));
+            }
+            if (ring->dropped() != dropped)
+            {
+                std::cerr << "Messages dropped by the logging process: " << ring->dropped() - dropped << std::endl;
+                dropped = ring->dropped();
+            }
+            if (skipped != 0)
+            {
+                std::cerr << "Binary records skipped after a lost one: " << skipped << std::endl;
+                skipped = 0;
+            }
+            if (stopping)
+            {
+                break;
+            }
+        }
+    }
+    catch (const spdlog::spdlog_ex &ex)
+    {
+        std::cerr << "spdlog-shm-reader failed: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -14,6 +14,9 @@
 //    2. Push a new copy of the message to a queue (or block the caller until space is available in the queue)
 //    3. will throw spdlog_ex upon log exceptions
 // Upon destruction, logs all remaining messages in the queue before destructing..
+//
+// With several slow sinks, sink_threads > 0 lets the back thread pass the messages to the sinks in parallel,
+// using up to sink_threads helper threads (see details/async_log_helper.h).
 
 #include "common.h"
 #include "logger.h"
@@ -37,19 +40,19 @@ public:
         const async_overflow_policy overflow_policy = async_overflow_policy::block_retry,
         const std::function<void()> &worker_warmup_cb = nullptr,
         const std::chrono::milliseconds &flush_interval_ms = std::chrono::milliseconds::zero(),
-        const std::function<void()> &worker_teardown_cb = nullptr);
+        const std::function<void()> &worker_teardown_cb = nullptr, size_t sink_threads = 0);
 
     async_logger(const std::string &logger_name, sinks_init_list sinks, size_t queue_size,
         const async_overflow_policy overflow_policy = async_overflow_policy::block_retry,
         const std::function<void()> &worker_warmup_cb = nullptr,
         const std::chrono::milliseconds &flush_interval_ms = std::chrono::milliseconds::zero(),
-        const std::function<void()> &worker_teardown_cb = nullptr);
+        const std::function<void()> &worker_teardown_cb = nullptr, size_t sink_threads = 0);
 
     async_logger(const std::string &logger_name, sink_ptr single_sink, size_t queue_size,
         const async_overflow_policy overflow_policy = async_overflow_policy::block_retry,
         const std::function<void()> &worker_warmup_cb = nullptr,
         const std::chrono::milliseconds &flush_interval_ms = std::chrono::milliseconds::zero(),
-        const std::function<void()> &worker_teardown_cb = nullptr);
+        const std::function<void()> &worker_teardown_cb = nullptr, size_t sink_threads = 0);
 
     // Wait for the queue to be empty, and flush synchronously
     // Warning: this can potentially last forever as we wait it to complete
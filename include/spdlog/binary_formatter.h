@@ -0,0 +1,87 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+#pragma once
+
+// Compact binary log format.
+//
+// Instead of rendering text, each message is stored as
+// (timestamp delta, level, thread id, logger name id, format string id, packed args).
+// Format strings and logger names are written once to the stream (the first time they are seen)
+// and referenced by id afterwards.
+// Messages whose arguments cannot be stored unformatted (custom types, async loggers, printf style)
+// are stored as preformatted text.
+//
+// Use binary_reader (or the spdlog-decode example tool) to render the stream back to text using any pattern.
+
+#include "formatter.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace spdlog {
+
+class binary_formatter SPDLOG_FINAL : public formatter
+{
+public:
+    // strings interned beyond max_strings are stored inline in each record instead
+    explicit binary_formatter(size_t max_strings = 4096);
+    binary_formatter(const binary_formatter &) = delete;
+    binary_formatter &operator=(const binary_formatter &) = delete;
+
+    // encode the message into msg.formatted
+    void format(details::log_msg &msg) override;
+
+    // encode the message and append it to dest
+    void format(const details::log_msg &msg, fmt::Writer &dest);
+
+    // forget all interned strings. the next record will be preceded by a new stream header.
+    void reset();
+
+private:
+    static const uint32_t no_id = 0xffffffff;
+
+    uint32_t intern(const void *key, const char *str, size_t size, fmt::Writer &dest);
+    bool encode_args(const details::log_msg &msg, fmt::Writer &dest);
+
+    const size_t _max_strings;
+    bool _header_written{false};
+    int64_t _last_time{0};
+    std::unordered_map<const void *, uint32_t> _ids_by_ptr;
+    std::unordered_map<std::string, uint32_t> _ids_by_str;
+    std::vector<std::string> _strings;
+    fmt::MemoryWriter _args_buf;
+};
+
+// Decode a binary log stream (as produced by binary_formatter) back to log messages
+class binary_reader
+{
+public:
+    binary_reader();
+    binary_reader(const char *data, size_t size);
+    binary_reader(const binary_reader &) = delete;
+    binary_reader &operator=(const binary_reader &) = delete;
+
+    // continue with the next part of the stream: the strings defined by the previous parts remain known
+    void set_input(const char *data, size_t size);
+
+    // fill msg with the next message in the stream. return false at end of stream.
+    // throw spdlog_ex if the stream is corrupted
+    bool next(details::log_msg &msg);
+
+private:
+    void read_header();
+    void read_args(fmt::Writer &raw, const std::string &fmt_str);
+
+    const char *_pos;
+    const char *_end;
+    int64_t _last_time{0};
+    std::vector<std::string> _strings;
+};
+} // namespace spdlog
+
+#include "details/binary_formatter_impl.h"
@@ -51,6 +51,35 @@
 
 #include "fmt/fmt.h"
 
+// inline capacity of log_msg's own message buffers, used when the per thread buffers are not. See tweakme.h
+#if !defined(SPDLOG_MSG_INLINE_BUFFER_SIZE)
+#define SPDLOG_MSG_INLINE_BUFFER_SIZE 256
+#endif
+
+#if !defined(SPDLOG_FUNCTION)
+#define SPDLOG_FUNCTION __FUNCTION__
+#endif
+
+// numeric log levels, usable in preprocessor conditions
+#define SPDLOG_LEVEL_TRACE 0
+#define SPDLOG_LEVEL_DEBUG 1
+#define SPDLOG_LEVEL_INFO 2
+#define SPDLOG_LEVEL_WARN 3
+#define SPDLOG_LEVEL_ERROR 4
+#define SPDLOG_LEVEL_CRITICAL 5
+#define SPDLOG_LEVEL_OFF 6
+
+// log calls made through the SPDLOG_<LEVEL> macros below this level are compiled out. See tweakme.h
+#if !defined(SPDLOG_ACTIVE_LEVEL)
+#if defined(SPDLOG_TRACE_ON)
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+#elif defined(SPDLOG_DEBUG_ON)
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_DEBUG
+#else
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_INFO
+#endif
+#endif
+
 namespace spdlog {
 
 class formatter;
@@ -75,13 +104,13 @@ using log_err_handler = std::function<void(const std::string &err_msg)>;
 namespace level {
 enum level_enum
 {
-    trace = 0,
-    debug = 1,
-    info = 2,
-    warn = 3,
-    err = 4,
-    critical = 5,
-    off = 6
+    trace = SPDLOG_LEVEL_TRACE,
+    debug = SPDLOG_LEVEL_DEBUG,
+    info = SPDLOG_LEVEL_INFO,
+    warn = SPDLOG_LEVEL_WARN,
+    err = SPDLOG_LEVEL_ERROR,
+    critical = SPDLOG_LEVEL_CRITICAL,
+    off = SPDLOG_LEVEL_OFF
 };
 
 #if !defined(SPDLOG_LEVEL_NAMES)
@@ -130,6 +159,73 @@ enum class async_overflow_policy
     discard_log_msg // Discard the message it enqueue fails
 };
 
+//
+// Log message fields captured upon each log call.
+// Formatters and sinks report which of them they use, so loggers can skip capturing the rest.
+//
+namespace capture {
+enum flags : unsigned
+{
+    none = 0,
+    time = 1,
+    thread_id = 2,
+    raw = 4, // the message text before formatting: always filled, but sinks queuing messages copy it only if needed
+    all = time | thread_id | raw
+};
+} // namespace capture
+
+//
+// Source code location of a log call.
+// The SPDLOG_<LEVEL> macros keep one static record per call site and pass it by reference,
+// so the strings must outlive the log call (string literals, __FILE__ and __FUNCTION__ do).
+//
+namespace details {
+// the part of path after the last path separator. computed at compile time for the macros' records.
+SPDLOG_CONSTEXPR inline const char *source_basename(const char *path, const char *base)
+{
+    return *path == '\0' ? base : source_basename(path + 1, (*path == '/' || *path == '\\') ? path + 1 : base);
+}
+} // namespace details
+
+struct source_loc
+{
+    SPDLOG_CONSTEXPR source_loc()
+        : filename(nullptr)
+        , basename(nullptr)
+        , line(0)
+        , funcname(nullptr)
+    {
+    }
+
+    SPDLOG_CONSTEXPR source_loc(const char *filename_in, int line_in, const char *funcname_in)
+        : filename(filename_in)
+        , basename(details::source_basename(filename_in, filename_in))
+        , line(line_in)
+        , funcname(funcname_in)
+    {
+    }
+
+    SPDLOG_CONSTEXPR bool empty() const
+    {
+        return line == 0;
+    }
+
+    const char *filename;
+    const char *basename;
+    int line;
+    const char *funcname;
+};
+
+//
+// State of a log call site, set at runtime (see spdlog::set_log_sites_by_file() and friends)
+//
+enum class log_site_state
+{
+    follow_level, // log if the logger's level allows it (the default)
+    enabled,      // always log, regardless of the logger's level
+    disabled      // never log
+};
+
 //
 // Pattern time - specific time getting to use for pattern_formatter.
 // local time by default
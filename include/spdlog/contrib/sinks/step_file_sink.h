@@ -84,11 +84,13 @@ public:
         if (!file_header.empty())
         {
             pattern_formatter formatter_for_file_header("%v");
-            _file_header.raw << file_header;
-            formatter_for_file_header.format(_file_header);
+            details::log_msg header_msg;
+            header_msg.raw << file_header;
+            formatter_for_file_header.format(header_msg);
+            _file_header.assign(header_msg.formatted.data(), header_msg.formatted.size());
         }
 
-        if (max_size <= _file_header.formatted.size())
+        if (max_size <= _file_header.size())
         {
             throw spdlog_ex("step_file_sink: Invalid max log size in ctor");
         }
@@ -106,9 +108,9 @@ public:
 
         if (!_current_size)
         {
-            _current_size += _file_header.formatted.size();
+            _current_size += _file_header.size();
             if (_current_size)
-                _file_helper.write(_file_header);
+                _file_helper.write(_file_header.data(), _file_header.size());
         }
     }
 
@@ -147,9 +149,9 @@ protected:
 
             if (change_occured)
             {
-                _current_size = _file_header.formatted.size();
+                _current_size = _file_header.size();
                 if (_current_size)
-                    _file_helper.write(_file_header);
+                    _file_helper.write(_file_header.data(), _file_header.size());
             }
         }
 
@@ -173,7 +175,7 @@ private:
         using details::os::filename_to_str;
 
         // Delete empty files, if required
-        if (_delete_empty_files && _current_size <= _file_header.formatted.size())
+        if (_delete_empty_files && _current_size <= _file_header.size())
         {
             if (details::os::remove(_current_filename) != 0)
             {
@@ -206,7 +208,8 @@ private:
     unsigned _current_size;
 
     details::file_helper _file_helper;
-    details::log_msg _file_header;
+    // the formatted header
+    std::string _file_header;
 };
 
 using step_file_sink_mt = step_file_sink<std::mutex>;
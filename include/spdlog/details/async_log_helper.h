@@ -9,16 +9,24 @@
 // If the internal queue of log messages reaches its max size,
 // then the client call will block until there is more room.
 //
+// With sink threads, the worker takes the messages queued in batches, formats them, and passes each batch to the
+// sinks in parallel on a pool of helper threads (one sink per thread at a time), so a logger with several slow
+// sinks is as fast as the slowest one instead of their sum. Each sink still receives the messages in order.
+// The error handler may then be called from several threads at once.
+//
 
 #pragma once
 
 #include "../common.h"
+#include "../details/dispatch_pool.h"
 #include "../details/log_msg.h"
 #include "../details/mpmc_blocking_q.h"
 #include "../details/os.h"
+#include "../details/sink_dispatch.h"
 #include "../formatter.h"
 #include "../sinks/sink.h"
 
+#include <algorithm>
 #include <chrono>
 #include <condition_variable>
 #include <exception>
@@ -47,10 +55,14 @@ class async_log_helper
     {
         level::level_enum level;
         log_clock::time_point time;
+#ifdef SPDLOG_CLOCK_TSC
+        uint64_t ticks;
+#endif
         size_t thread_id;
         std::string txt;
         async_msg_type msg_type;
         size_t msg_id;
+        source_loc source;
 
         async_msg() = default;
         ~async_msg() = default;
@@ -74,10 +86,14 @@ class async_log_helper
         explicit async_msg(const details::log_msg &m)
             : level(m.level)
             , time(m.time)
+#ifdef SPDLOG_CLOCK_TSC
+            , ticks(m.ticks)
+#endif
             , thread_id(m.thread_id)
             , txt(m.raw.data(), m.raw.size())
             , msg_type(async_msg_type::log)
             , msg_id(m.msg_id)
+            , source(m.source != nullptr ? *m.source : source_loc())
         {
         }
 
@@ -87,10 +103,14 @@ class async_log_helper
             msg.logger_name = logger_name;
             msg.level = level;
             msg.time = time;
+#ifdef SPDLOG_CLOCK_TSC
+            msg.ticks = ticks;
+#endif
             msg.thread_id = thread_id;
             msg.raw.clear();
             msg.raw << txt;
             msg.msg_id = msg_id;
+            msg.source = &source;
         }
     };
 
@@ -104,7 +124,7 @@ public:
         const log_err_handler err_handler, const async_overflow_policy overflow_policy = async_overflow_policy::block_retry,
         std::function<void()> worker_warmup_cb = nullptr,
         const std::chrono::milliseconds &flush_interval_ms = std::chrono::milliseconds::zero(),
-        std::function<void()> worker_teardown_cb = nullptr);
+        std::function<void()> worker_teardown_cb = nullptr, size_t sink_threads = 0);
 
     void log(const details::log_msg &msg);
 
@@ -124,6 +144,7 @@ private:
     std::string _logger_name;
     formatter_ptr _formatter;
     std::vector<std::shared_ptr<sinks::sink>> _sinks;
+    sink_dispatch_table _sink_dispatch{_sinks};
 
     // queue of messages to log
     q_type _q;
@@ -149,6 +170,21 @@ private:
     std::condition_variable_any not_empty_cv_;
     std::condition_variable_any not_full_cv_;
 
+    // helper threads passing the messages to the sinks in parallel (null: the worker passes them one sink after the other)
+    std::unique_ptr<dispatch_pool> _sink_pool;
+    // one task per distinct sink (a sink added twice must not be run by two threads): the index of its first
+    // occurrence in _sinks and its number of occurrences
+    std::vector<std::pair<size_t, size_t>> _sink_tasks;
+
+    // messages processed at once with sink threads
+    static const size_t max_batch_size = 256;
+    std::vector<async_msg> _batch;
+    // allocated by the worker thread, which owns their scratch buffers
+    std::unique_ptr<log_msg[]> _batch_msgs;
+    // flush or terminate message ending the last batch, handled by process_next_msg() if the batch failed
+    async_msg _control_msg;
+    bool _has_control_msg{false};
+
     // worker thread
     std::thread _worker_thread;
 
@@ -161,6 +197,10 @@ private:
     // return false if termination of the queue is required
     bool process_next_msg();
 
+    // with sink threads: process the given message and the next ones already queued.
+    // return false if termination of the queue is required
+    bool process_batch(async_msg &&first_msg);
+
     void handle_flush_interval();
 
     void flush_sinks();
@@ -173,7 +213,7 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 inline spdlog::details::async_log_helper::async_log_helper(std::string logger_name, formatter_ptr formatter, std::vector<sink_ptr> sinks,
     size_t queue_size, log_err_handler err_handler, const async_overflow_policy overflow_policy, std::function<void()> worker_warmup_cb,
-    const std::chrono::milliseconds &flush_interval_ms, std::function<void()> worker_teardown_cb)
+    const std::chrono::milliseconds &flush_interval_ms, std::function<void()> worker_teardown_cb, size_t sink_threads)
     : _logger_name(std::move(logger_name))
     , _formatter(std::move(formatter))
     , _sinks(std::move(sinks))
@@ -185,6 +225,25 @@ inline spdlog::details::async_log_helper::async_log_helper(std::string logger_na
     , _flush_interval_ms(flush_interval_ms)
     , _worker_teardown_cb(std::move(worker_teardown_cb))
 {
+    for (size_t i = 0; i < _sinks.size(); i++)
+    {
+        auto it = std::find_if(_sink_tasks.begin(), _sink_tasks.end(),
+            [this, i](const std::pair<size_t, size_t> &task) { return _sinks[task.first] == _sinks[i]; });
+        if (it == _sink_tasks.end())
+        {
+            _sink_tasks.emplace_back(i, 1);
+        }
+        else
+        {
+            it->second++;
+        }
+    }
+    if (sink_threads > 0 && _sink_tasks.size() > 1)
+    {
+        // the worker thread takes part in the dispatch as well
+        _sink_pool.reset(new dispatch_pool(std::min(sink_threads, _sink_tasks.size() - 1)));
+        _batch.reserve(max_batch_size);
+    }
     _worker_thread = std::thread(&async_log_helper::worker_loop, this);
 }
 
@@ -233,6 +292,10 @@ inline void spdlog::details::async_log_helper::worker_loop()
     {
         _worker_warmup_cb();
     }
+    if (_sink_pool)
+    {
+        _batch_msgs.reset(new log_msg[max_batch_size]);
+    }
     auto active = true;
     while (active)
     {
@@ -242,6 +305,7 @@ inline void spdlog::details::async_log_helper::worker_loop()
         }
         SPDLOG_CATCH_AND_HANDLE
     }
+    _batch_msgs.reset();
     if (_worker_teardown_cb)
     {
         _worker_teardown_cb();
@@ -253,7 +317,16 @@ inline void spdlog::details::async_log_helper::worker_loop()
 inline bool spdlog::details::async_log_helper::process_next_msg()
 {
     async_msg incoming_async_msg;
-    bool dequeued = _q.dequeue_for(incoming_async_msg, std::chrono::seconds(2));
+    bool dequeued = true;
+    if (_has_control_msg)
+    {
+        incoming_async_msg = std::move(_control_msg);
+        _has_control_msg = false;
+    }
+    else
+    {
+        dequeued = _q.dequeue_for(incoming_async_msg, std::chrono::seconds(2));
+    }
     if (!dequeued)
     {
         handle_flush_interval();
@@ -271,20 +344,21 @@ inline bool spdlog::details::async_log_helper::process_next_msg()
         return false;
 
     default:
+        if (_sink_pool)
+        {
+            return process_batch(std::move(incoming_async_msg));
+        }
         log_msg incoming_log_msg;
         incoming_async_msg.fill_log_msg(incoming_log_msg, &_logger_name);
+        incoming_log_msg.resolve_time();
         _formatter->format(incoming_log_msg);
-        for (auto &s : _sinks)
-        {
-            if (s->should_log(incoming_log_msg.level))
+        _sink_dispatch.for_each(incoming_log_msg.level, [&](sinks::sink &s) {
+            try
             {
-                try
-                {
-                    s->log(incoming_log_msg);
-                }
-                SPDLOG_CATCH_AND_HANDLE
+                s.log(incoming_log_msg);
             }
-        }
+            SPDLOG_CATCH_AND_HANDLE
+        });
         handle_flush_interval();
         return true;
     }
@@ -292,6 +366,74 @@ inline bool spdlog::details::async_log_helper::process_next_msg()
     return true; // should not be reached
 }
 
+inline bool spdlog::details::async_log_helper::process_batch(async_msg &&first_msg)
+{
+    // take the log messages already queued, up to a flush or terminate message. the latter is kept in _control_msg
+    // until handled, so it is not lost if the batch fails.
+    _batch.clear();
+    _batch.push_back(std::move(first_msg));
+    async_msg next_msg;
+    while (_batch.size() < max_batch_size && _q.dequeue_for(next_msg, std::chrono::milliseconds::zero()))
+    {
+        if (next_msg.msg_type != async_msg_type::log)
+        {
+            _control_msg = std::move(next_msg);
+            _has_control_msg = true;
+            break;
+        }
+        _batch.push_back(std::move(next_msg));
+    }
+
+    // messages failing to format are reported and skipped
+    size_t count = 0;
+    for (auto &queued : _batch)
+    {
+        auto &msg = _batch_msgs[count];
+        try
+        {
+            msg.formatted.clear();
+            msg.color_range_start = 0;
+            msg.color_range_end = 0;
+            queued.fill_log_msg(msg, &_logger_name);
+            msg.resolve_time();
+            _formatter->format(msg);
+            count++;
+        }
+        SPDLOG_CATCH_AND_HANDLE
+    }
+
+    // each sink takes the whole batch, in order
+    _sink_pool->run(_sink_tasks.size(), [this, count](size_t task_index) {
+        auto sink_index = _sink_tasks[task_index].first;
+        auto occurrences = _sink_tasks[task_index].second;
+        auto &s = *_sinks[sink_index];
+        for (size_t i = 0; i < count; i++)
+        {
+            auto &msg = _batch_msgs[i];
+            if (_sink_dispatch.accepts(msg.level, sink_index))
+            {
+                for (size_t n = 0; n < occurrences; n++)
+                {
+                    try
+                    {
+                        s.log(msg);
+                    }
+                    SPDLOG_CATCH_AND_HANDLE
+                }
+            }
+        }
+    });
+    handle_flush_interval();
+
+    if (_has_control_msg)
+    {
+        _has_control_msg = false;
+        flush_sinks();
+        return _control_msg.msg_type != async_msg_type::terminate;
+    }
+    return true;
+}
+
 inline void spdlog::details::async_log_helper::set_formatter(formatter_ptr msg_formatter)
 {
     _formatter = std::move(msg_formatter);
@@ -19,26 +19,29 @@
 template<class It>
 inline spdlog::async_logger::async_logger(const std::string &logger_name, const It &begin, const It &end, size_t queue_size,
     const async_overflow_policy overflow_policy, const std::function<void()> &worker_warmup_cb,
-    const std::chrono::milliseconds &flush_interval_ms, const std::function<void()> &worker_teardown_cb)
+    const std::chrono::milliseconds &flush_interval_ms, const std::function<void()> &worker_teardown_cb,
+    size_t sink_threads)
     : logger(logger_name, begin, end)
     , _async_log_helper(new details::async_log_helper(logger_name, _formatter, _sinks, queue_size, _err_handler, overflow_policy,
-          worker_warmup_cb, flush_interval_ms, worker_teardown_cb))
+          worker_warmup_cb, flush_interval_ms, worker_teardown_cb, sink_threads))
 {
 }
 
 inline spdlog::async_logger::async_logger(const std::string &logger_name, sinks_init_list sinks_list, size_t queue_size,
     const async_overflow_policy overflow_policy, const std::function<void()> &worker_warmup_cb,
-    const std::chrono::milliseconds &flush_interval_ms, const std::function<void()> &worker_teardown_cb)
+    const std::chrono::milliseconds &flush_interval_ms, const std::function<void()> &worker_teardown_cb,
+    size_t sink_threads)
     : async_logger(logger_name, sinks_list.begin(), sinks_list.end(), queue_size, overflow_policy, worker_warmup_cb, flush_interval_ms,
-          worker_teardown_cb)
+          worker_teardown_cb, sink_threads)
 {
 }
 
 inline spdlog::async_logger::async_logger(const std::string &logger_name, sink_ptr single_sink, size_t queue_size,
     const async_overflow_policy overflow_policy, const std::function<void()> &worker_warmup_cb,
-    const std::chrono::milliseconds &flush_interval_ms, const std::function<void()> &worker_teardown_cb)
-    : async_logger(
-          logger_name, {std::move(single_sink)}, queue_size, overflow_policy, worker_warmup_cb, flush_interval_ms, worker_teardown_cb)
+    const std::chrono::milliseconds &flush_interval_ms, const std::function<void()> &worker_teardown_cb,
+    size_t sink_threads)
+    : async_logger(logger_name, {std::move(single_sink)}, queue_size, overflow_policy, worker_warmup_cb, flush_interval_ms,
+          worker_teardown_cb, sink_threads)
 {
 }
 
@@ -61,12 +64,14 @@ inline spdlog::log_err_handler spdlog::async_logger::error_handler()
 inline void spdlog::async_logger::_set_formatter(spdlog::formatter_ptr msg_formatter)
 {
     _formatter = msg_formatter;
+    _formatter_changed();
     _async_log_helper->set_formatter(_formatter);
 }
 
 inline void spdlog::async_logger::_set_pattern(const std::string &pattern, pattern_time_type pattern_time)
 {
     _formatter = std::make_shared<pattern_formatter>(pattern, pattern_time);
+    _formatter_changed();
     _async_log_helper->set_formatter(_formatter);
 }
 
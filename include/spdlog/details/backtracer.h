@@ -0,0 +1,288 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+#pragma once
+
+// Ring of the last messages not logged because of the logger's level (see logger::enable_backtrace()).
+//
+// Messages are stored in preallocated slots, unformatted: the format string, the arg values and a copy of the
+// string args. Formatting happens only if the ring is dumped. Args which cannot be stored by value (custom types),
+// printf style and long messages are formatted when stored, and truncated to the slot's size.
+// Storing takes no lock. A message is dropped if its slot is being written or dumped by another thread.
+
+#include "../common.h"
+#include "../details/log_msg.h"
+#include "../details/msg_buffer.h"
+#include "../details/os.h"
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace spdlog {
+namespace details {
+
+class backtracer
+{
+public:
+    // bytes of format string and string args (or formatted text) kept per message
+    static const size_t slot_data_size = 256;
+
+    backtracer(size_t n_messages, level::level_enum trigger_level)
+        : _trigger_level(trigger_level)
+        , _n_slots(n_messages != 0 ? n_messages : 1)
+        , _slots(new slot[_n_slots])
+    {
+    }
+
+    backtracer(const backtracer &) = delete;
+    backtracer &operator=(const backtracer &) = delete;
+
+    level::level_enum trigger_level() const
+    {
+        return _trigger_level;
+    }
+
+    void push(const source_loc &loc, level::level_enum lvl, const char *fmt, const fmt::ArgList &args)
+    {
+        uint64_t index;
+        auto s = acquire_next(index);
+        if (s == nullptr)
+        {
+            return;
+        }
+        busy_guard guard(*s);
+        fill_header(*s, loc, lvl);
+        if (!store_args(*s, fmt, args))
+        {
+            if (args.types() == 0)
+            {
+                store_text(*s, fmt, std::strlen(fmt)); // plain string
+            }
+            else
+            {
+                scratch_writer w;
+                w.write(fmt, args);
+                store_text(*s, w.data(), w.size());
+            }
+        }
+        s->index = index;
+    }
+
+    void push_text(const source_loc &loc, level::level_enum lvl, const char *text, size_t size)
+    {
+        uint64_t index;
+        auto s = acquire_next(index);
+        if (s == nullptr)
+        {
+            return;
+        }
+        busy_guard guard(*s);
+        fill_header(*s, loc, lvl);
+        store_text(*s, text, size);
+        s->index = index;
+    }
+
+    // format the messages stored since the last dump, oldest first, pass each to sink_it and forget them.
+    // a message which fails to be formatted or logged is passed to err_handler and skipped.
+    template<class SinkIt>
+    void dump(const std::string *logger_name, SinkIt sink_it, const log_err_handler &err_handler)
+    {
+        std::lock_guard<std::mutex> lock(_dump_mutex);
+        auto end = _next.load(std::memory_order_acquire);
+        auto begin = end - _dumped > _n_slots ? end - _n_slots : _dumped;
+        _dumped = end;
+        for (auto index = begin; index != end; ++index)
+        {
+            auto &s = _slots[index % _n_slots];
+            try
+            {
+                log_msg msg(logger_name, level::off, capture::none);
+                source_loc source;
+                {
+                    while (s.busy.exchange(true, std::memory_order_acquire))
+                    {
+                        std::this_thread::yield();
+                    }
+                    busy_guard guard(s);
+                    if (s.index != index)
+                    {
+                        continue; // dropped, or already overwritten by a newer message
+                    }
+                    msg.level = s.level;
+                    msg.time = s.time;
+                    msg.thread_id = s.thread_id;
+                    source = s.source;
+                    msg.source = &source;
+                    if (s.types == 0)
+                    {
+                        msg.raw << fmt::StringRef(s.data, s.fmt_size);
+                    }
+                    else
+                    {
+                        msg.raw.write(fmt::CStringRef(s.data), fmt::ArgList(s.types, s.values));
+                    }
+                }
+                sink_it(msg);
+            }
+            catch (const std::exception &ex)
+            {
+                err_handler(ex.what());
+            }
+            catch (...)
+            {
+                err_handler("Unknown exception in backtrace");
+            }
+        }
+    }
+
+private:
+    static const uint64_t invalid_index = ~uint64_t(0);
+
+    struct slot
+    {
+        std::atomic<bool> busy{false};
+        uint64_t index{invalid_index};
+        log_clock::time_point time;
+        size_t thread_id{0};
+        level::level_enum level{level::off};
+        source_loc source;
+        // packed arg types, 0 if data holds plain text
+        uint64_t types{0};
+        fmt::internal::Value values[fmt::ArgList::MAX_PACKED_ARGS];
+        // size of the format string (or text) at the start of data, followed by the string args
+        size_t fmt_size{0};
+        char data[slot_data_size];
+    };
+
+    // clears the busy flag of a slot on scope exit, even if storing or formatting its message threw
+    class busy_guard
+    {
+    public:
+        explicit busy_guard(slot &s)
+            : _slot(s)
+        {
+        }
+
+        ~busy_guard()
+        {
+            _slot.busy.store(false, std::memory_order_release);
+        }
+
+        busy_guard(const busy_guard &) = delete;
+        busy_guard &operator=(const busy_guard &) = delete;
+
+    private:
+        slot &_slot;
+    };
+
+    // return the slot of the next message marked busy, or nullptr if it is taken.
+    // the slot holds no valid message until its index is set.
+    slot *acquire_next(uint64_t &index)
+    {
+        index = _next.fetch_add(1, std::memory_order_relaxed);
+        auto &s = _slots[index % _n_slots];
+        if (s.busy.exchange(true, std::memory_order_acquire))
+        {
+            return nullptr;
+        }
+        s.index = invalid_index;
+        return &s;
+    }
+
+    static void fill_header(slot &s, const source_loc &loc, level::level_enum lvl)
+    {
+        s.time = os::now();
+        s.thread_id = os::thread_id();
+        s.level = lvl;
+        s.source = loc;
+    }
+
+    static void store_text(slot &s, const char *text, size_t size)
+    {
+        s.types = 0;
+        s.fmt_size = size < slot_data_size ? size : slot_data_size;
+        std::memcpy(s.data, text, s.fmt_size);
+    }
+
+    // store the format string and args unformatted. return false if they do not fit or cannot be stored by value.
+    static bool store_args(slot &s, const char *fmt, const fmt::ArgList &args)
+    {
+        using fmt::internal::Arg;
+
+        // the format string is stored null terminated
+        auto fmt_size = std::strlen(fmt);
+        if (fmt_size >= slot_data_size)
+        {
+            return false;
+        }
+        std::memcpy(s.data, fmt, fmt_size + 1);
+        size_t used = fmt_size + 1;
+
+        auto types = args.types();
+        if (fmt::ArgList::type(types, fmt::ArgList::MAX_PACKED_ARGS - 1) != Arg::NONE)
+        {
+            return false; // too many args to pack
+        }
+
+        uint64_t stored_types = 0;
+        for (unsigned i = 0; i < fmt::ArgList::MAX_PACKED_ARGS - 1; ++i)
+        {
+            auto arg = args[i];
+            auto &v = s.values[i];
+            auto type = arg.type;
+            switch (arg.type)
+            {
+            case Arg::NONE:
+                s.types = stored_types;
+                s.fmt_size = fmt_size;
+                // no args: the format string is output as is, as done by logger::log(lvl, msg)
+                return true;
+            case Arg::INT:
+            case Arg::BOOL:
+            case Arg::CHAR:
+            case Arg::UINT:
+            case Arg::LONG_LONG:
+            case Arg::ULONG_LONG:
+            case Arg::DOUBLE:
+            case Arg::LONG_DOUBLE:
+            case Arg::POINTER:
+                v = arg;
+                break;
+            case Arg::CSTRING:
+            case Arg::STRING:
+            {
+                auto size = arg.type == Arg::CSTRING ? std::strlen(arg.string.value) : arg.string.size;
+                if (size > slot_data_size - used)
+                {
+                    return false;
+                }
+                std::memcpy(s.data + used, arg.string.value, size);
+                v.string.value = s.data + used;
+                v.string.size = size;
+                used += size;
+                type = Arg::STRING;
+                break;
+            }
+            default: // named, wide string and custom args refer to the caller's objects
+                return false;
+            }
+            stored_types |= static_cast<uint64_t>(type) << (4 * i);
+        }
+        return false;
+    }
+
+    const level::level_enum _trigger_level;
+    const uint64_t _n_slots;
+    std::unique_ptr<slot[]> _slots;
+    std::atomic<uint64_t> _next{0};
+    std::mutex _dump_mutex;
+    uint64_t _dumped{0}; // guarded by _dump_mutex
+};
+
+} // namespace details
+} // namespace spdlog
@@ -0,0 +1,478 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+#pragma once
+
+#include "../binary_formatter.h"
+#include "../details/log_msg.h"
+
+#include <chrono>
+#include <cstring>
+#include <string>
+
+namespace spdlog {
+namespace details {
+namespace binary {
+
+// Stream layout (all integers are LEB128 varints unless noted):
+//
+// header:         u8 tag_header, "SPDLOGB", u8 version
+// string:         u8 tag_string, id, size, bytes
+// message:        u8 tag_message, zigzag time delta(ns), u8 level, thread id, logger name id, format string id,
+//                 u8 arg count, {u8 arg type, value}...
+// preformatted:   u8 tag_preformatted, zigzag time delta(ns), u8 level, thread id, logger name id, size, bytes
+//
+// A message with no args holds a plain string (not a format string) and is output as is.
+enum record_tag : unsigned char
+{
+    tag_header = 0,
+    tag_string = 1,
+    tag_message = 2,
+    tag_preformatted = 3
+};
+
+static const char magic[] = "SPDLOGB";
+static const unsigned char version = 1;
+
+inline void write_u8(fmt::Writer &w, unsigned char v)
+{
+    w.buffer().push_back(static_cast<char>(v));
+}
+
+inline void write_varint(fmt::Writer &w, uint64_t v)
+{
+    while (v >= 0x80)
+    {
+        write_u8(w, static_cast<unsigned char>(v | 0x80));
+        v >>= 7;
+    }
+    write_u8(w, static_cast<unsigned char>(v));
+}
+
+inline void write_zigzag(fmt::Writer &w, int64_t v)
+{
+    write_varint(w, (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+}
+
+inline void write_bytes(fmt::Writer &w, const char *data, size_t size)
+{
+    write_varint(w, size);
+    w.buffer().append(data, data + size);
+}
+
+inline int64_t to_nanos(const log_msg &msg)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(msg.time.time_since_epoch()).count();
+}
+
+} // namespace binary
+} // namespace details
+} // namespace spdlog
+
+///////////////////////////////////////////////////////////////////////////////
+// binary_formatter inline impl
+///////////////////////////////////////////////////////////////////////////////
+inline spdlog::binary_formatter::binary_formatter(size_t max_strings)
+    : _max_strings(max_strings)
+{
+}
+
+inline void spdlog::binary_formatter::reset()
+{
+    _header_written = false;
+    _last_time = 0;
+    _ids_by_ptr.clear();
+    _ids_by_str.clear();
+    _strings.clear();
+}
+
+inline void spdlog::binary_formatter::format(details::log_msg &msg)
+{
+    format(msg, msg.formatted);
+}
+
+inline void spdlog::binary_formatter::format(const details::log_msg &msg, fmt::Writer &dest)
+{
+    using namespace details::binary;
+    if (!_header_written)
+    {
+        write_u8(dest, tag_header);
+        dest.buffer().append(magic, magic + sizeof(magic) - 1);
+        write_u8(dest, version);
+        _header_written = true;
+    }
+
+    static const std::string no_name;
+    const std::string &logger_name = msg.logger_name ? *msg.logger_name : no_name;
+    // logger names are few, so they are always interned
+    auto logger_id = intern(&logger_name, logger_name.data(), logger_name.size(), dest);
+
+    auto fmt_id = no_id;
+    if (msg.fmt_str != nullptr && encode_args(msg, _args_buf))
+    {
+        fmt_id = intern(msg.fmt_str, msg.fmt_str, std::strlen(msg.fmt_str), dest);
+    }
+
+    auto time = to_nanos(msg);
+    write_u8(dest, fmt_id != no_id ? tag_message : tag_preformatted);
+    write_zigzag(dest, time - _last_time);
+    write_u8(dest, static_cast<unsigned char>(msg.level));
+    write_varint(dest, msg.thread_id);
+    write_varint(dest, logger_id);
+    if (fmt_id != no_id)
+    {
+        write_varint(dest, fmt_id);
+        dest.buffer().append(_args_buf.data(), _args_buf.data() + _args_buf.size());
+    }
+    else
+    {
+        write_bytes(dest, msg.raw.data(), msg.raw.size());
+    }
+    _last_time = time;
+}
+
+// return the id of the given string, writing its definition to dest if seen for the first time.
+// return no_id if the string table is full.
+inline uint32_t spdlog::binary_formatter::intern(const void *key, const char *str, size_t size, fmt::Writer &dest)
+{
+    // fast path: same pointer as before (string literals, logger names) and same content
+    auto by_ptr = _ids_by_ptr.find(key);
+    if (by_ptr != _ids_by_ptr.end() && _strings[by_ptr->second].compare(0, std::string::npos, str, size) == 0)
+    {
+        return by_ptr->second;
+    }
+
+    std::string s(str, size);
+    uint32_t id;
+    auto by_str = _ids_by_str.find(s);
+    if (by_str != _ids_by_str.end())
+    {
+        id = by_str->second;
+    }
+    else
+    {
+        if (_strings.size() >= _max_strings && key != str) // logger names (key != str) are never rejected
+        {
+            return no_id;
+        }
+        id = static_cast<uint32_t>(_strings.size());
+        details::binary::write_u8(dest, details::binary::tag_string);
+        details::binary::write_varint(dest, id);
+        details::binary::write_bytes(dest, str, size);
+        _strings.push_back(s);
+        _ids_by_str.emplace(std::move(s), id);
+    }
+
+    // the pointer cache can grow with dynamic strings of the same content. keep it bounded.
+    if (_ids_by_ptr.size() >= _max_strings * 4)
+    {
+        _ids_by_ptr.clear();
+    }
+    _ids_by_ptr[key] = id;
+    return id;
+}
+
+// encode the message args into dest. return false if any of the args cannot be stored unformatted.
+inline bool spdlog::binary_formatter::encode_args(const details::log_msg &msg, fmt::Writer &dest)
+{
+    using namespace details::binary;
+    using fmt::internal::Arg;
+
+    dest.clear();
+    auto types = msg.fmt_args.types();
+    if (fmt::ArgList::type(types, fmt::ArgList::MAX_PACKED_ARGS - 1) != Arg::NONE)
+    {
+        return false; // too many args to pack
+    }
+
+    unsigned count = 0;
+    while (count < fmt::ArgList::MAX_PACKED_ARGS && fmt::ArgList::type(types, count) != Arg::NONE)
+    {
+        ++count;
+    }
+    write_u8(dest, static_cast<unsigned char>(count));
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        auto arg = msg.fmt_args[i];
+        switch (arg.type)
+        {
+        case Arg::INT:
+        case Arg::BOOL:
+        case Arg::CHAR:
+            write_u8(dest, static_cast<unsigned char>(arg.type));
+            write_zigzag(dest, arg.int_value);
+            break;
+        case Arg::UINT:
+            write_u8(dest, static_cast<unsigned char>(arg.type));
+            write_varint(dest, arg.uint_value);
+            break;
+        case Arg::LONG_LONG:
+            write_u8(dest, static_cast<unsigned char>(arg.type));
+            write_zigzag(dest, arg.long_long_value);
+            break;
+        case Arg::ULONG_LONG:
+            write_u8(dest, static_cast<unsigned char>(arg.type));
+            write_varint(dest, arg.ulong_long_value);
+            break;
+        case Arg::DOUBLE:
+        case Arg::LONG_DOUBLE:
+        {
+            // long doubles are narrowed to double
+            double d = arg.type == Arg::DOUBLE ? arg.double_value : static_cast<double>(arg.long_double_value);
+            write_u8(dest, static_cast<unsigned char>(Arg::DOUBLE));
+            dest.buffer().append(reinterpret_cast<const char *>(&d), reinterpret_cast<const char *>(&d) + sizeof(d));
+            break;
+        }
+        case Arg::CSTRING:
+            write_u8(dest, static_cast<unsigned char>(Arg::STRING));
+            write_bytes(dest, arg.string.value, std::strlen(arg.string.value));
+            break;
+        case Arg::STRING:
+            write_u8(dest, static_cast<unsigned char>(Arg::STRING));
+            write_bytes(dest, arg.string.value, arg.string.size);
+            break;
+        case Arg::POINTER:
+            write_u8(dest, static_cast<unsigned char>(Arg::POINTER));
+            write_varint(dest, reinterpret_cast<uintptr_t>(arg.pointer));
+            break;
+        default: // named, wide string and custom args are stored preformatted
+            return false;
+        }
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// binary_reader inline impl
+///////////////////////////////////////////////////////////////////////////////
+namespace spdlog {
+namespace details {
+namespace binary {
+
+class input
+{
+public:
+    input(const char *&pos, const char *end)
+        : _pos(pos)
+        , _end(end)
+    {
+    }
+
+    unsigned char read_u8()
+    {
+        require(1);
+        return static_cast<unsigned char>(*_pos++);
+    }
+
+    uint64_t read_varint()
+    {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            auto b = read_u8();
+            v |= static_cast<uint64_t>(b & 0x7f) << shift;
+            if ((b & 0x80) == 0)
+            {
+                return v;
+            }
+        }
+        throw spdlog_ex("binary_reader: invalid varint");
+    }
+
+    int64_t read_zigzag()
+    {
+        auto v = read_varint();
+        return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+    }
+
+    const char *read_bytes(size_t &size)
+    {
+        size = static_cast<size_t>(read_varint());
+        require(size);
+        auto data = _pos;
+        _pos += size;
+        return data;
+    }
+
+    const char *read_raw(size_t size)
+    {
+        require(size);
+        auto data = _pos;
+        _pos += size;
+        return data;
+    }
+
+private:
+    void require(size_t size)
+    {
+        if (static_cast<size_t>(_end - _pos) < size)
+        {
+            throw spdlog_ex("binary_reader: unexpected end of stream");
+        }
+    }
+
+    const char *&_pos;
+    const char *_end;
+};
+
+} // namespace binary
+} // namespace details
+} // namespace spdlog
+
+inline spdlog::binary_reader::binary_reader()
+    : _pos(nullptr)
+    , _end(nullptr)
+{
+}
+
+inline spdlog::binary_reader::binary_reader(const char *data, size_t size)
+    : _pos(data)
+    , _end(data + size)
+{
+}
+
+inline void spdlog::binary_reader::set_input(const char *data, size_t size)
+{
+    _pos = data;
+    _end = data + size;
+}
+
+inline void spdlog::binary_reader::read_header()
+{
+    using namespace details::binary;
+    input in(_pos, _end);
+    auto m = in.read_raw(sizeof(magic) - 1);
+    if (std::memcmp(m, magic, sizeof(magic) - 1) != 0 || in.read_u8() != version)
+    {
+        throw spdlog_ex("binary_reader: bad header");
+    }
+    _strings.clear();
+    _last_time = 0;
+}
+
+inline bool spdlog::binary_reader::next(details::log_msg &msg)
+{
+    using namespace details::binary;
+    input in(_pos, _end);
+    while (_pos < _end)
+    {
+        auto tag = in.read_u8();
+        if (tag == tag_header)
+        {
+            read_header();
+            continue;
+        }
+        if (tag == tag_string)
+        {
+            auto id = in.read_varint();
+            size_t size;
+            auto data = in.read_bytes(size);
+            if (id != _strings.size())
+            {
+                throw spdlog_ex("binary_reader: unexpected string id");
+            }
+            _strings.emplace_back(data, size);
+            continue;
+        }
+        if (tag != tag_message && tag != tag_preformatted)
+        {
+            throw spdlog_ex("binary_reader: unknown record type");
+        }
+
+        _last_time += in.read_zigzag();
+        auto lvl = in.read_u8();
+        if (lvl > level::off)
+        {
+            throw spdlog_ex("binary_reader: invalid level");
+        }
+        msg.level = static_cast<level::level_enum>(lvl);
+        msg.time = log_clock::time_point(std::chrono::duration_cast<log_clock::duration>(std::chrono::nanoseconds(_last_time)));
+        msg.thread_id = static_cast<size_t>(in.read_varint());
+        auto logger_id = in.read_varint();
+        if (logger_id >= _strings.size())
+        {
+            throw spdlog_ex("binary_reader: unknown logger name id");
+        }
+        msg.logger_name = &_strings[logger_id];
+        msg.raw.clear();
+        msg.formatted.clear();
+        msg.color_range_start = msg.color_range_end = 0;
+
+        if (tag == tag_preformatted)
+        {
+            size_t size;
+            auto data = in.read_bytes(size);
+            msg.raw << fmt::StringRef(data, size);
+        }
+        else
+        {
+            auto fmt_id = in.read_varint();
+            if (fmt_id >= _strings.size())
+            {
+                throw spdlog_ex("binary_reader: unknown format string id");
+            }
+            read_args(msg.raw, _strings[fmt_id]);
+        }
+        return true;
+    }
+    return false;
+}
+
+inline void spdlog::binary_reader::read_args(fmt::Writer &raw, const std::string &fmt_str)
+{
+    using namespace details::binary;
+    using fmt::internal::Arg;
+
+    input in(_pos, _end);
+    unsigned count = in.read_u8();
+    if (count == 0)
+    {
+        raw << fmt_str; // plain string, not a format string
+        return;
+    }
+    if (count >= fmt::ArgList::MAX_PACKED_ARGS)
+    {
+        throw spdlog_ex("binary_reader: too many args");
+    }
+
+    fmt::internal::Value values[fmt::ArgList::MAX_PACKED_ARGS];
+    uint64_t types = 0;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        auto type = static_cast<Arg::Type>(in.read_u8());
+        auto &v = values[i];
+        switch (type)
+        {
+        case Arg::INT:
+        case Arg::BOOL:
+        case Arg::CHAR:
+            v.int_value = static_cast<int>(in.read_zigzag());
+            break;
+        case Arg::UINT:
+            v.uint_value = static_cast<unsigned>(in.read_varint());
+            break;
+        case Arg::LONG_LONG:
+            v.long_long_value = in.read_zigzag();
+            break;
+        case Arg::ULONG_LONG:
+            v.ulong_long_value = in.read_varint();
+            break;
+        case Arg::DOUBLE:
+            std::memcpy(&v.double_value, in.read_raw(sizeof(double)), sizeof(double));
+            break;
+        case Arg::STRING:
+            v.string.value = in.read_bytes(v.string.size);
+            break;
+        case Arg::POINTER:
+            v.pointer = reinterpret_cast<const void *>(static_cast<uintptr_t>(in.read_varint()));
+            break;
+        default:
+            throw spdlog_ex("binary_reader: invalid arg type");
+        }
+        types |= static_cast<uint64_t>(type) << (4 * i);
+    }
+    raw.write(fmt_str.c_str(), fmt::ArgList(types, values));
+}
@@ -0,0 +1,136 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+#pragma once
+
+// Datagrams waiting to be sent on a connected non blocking socket, stored back to back in one reusable buffer.
+// They are sent with a single sendmmsg() call on Linux, one send() each elsewhere.
+// Used by the datagram sinks (native_syslog_sink, udp_sink). Not thread safe: used under the sink's mutex.
+
+#ifndef _WIN32
+
+#include "../common.h"
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+
+namespace spdlog {
+namespace details {
+
+class datagram_batch
+{
+public:
+    static const size_t max_datagrams = 64;
+
+    datagram_batch()
+    {
+        _datagrams.reserve(max_datagrams);
+    }
+
+    datagram_batch(const datagram_batch &) = delete;
+    datagram_batch &operator=(const datagram_batch &) = delete;
+
+    // append a datagram: call start(), write it to writer(), then call finish()
+    void start()
+    {
+        _start = _buffer.size();
+    }
+
+    fmt::MemoryWriter &writer()
+    {
+        return _buffer;
+    }
+
+    // return the size of the datagram appended
+    size_t finish()
+    {
+        _datagrams.emplace_back(_start, _buffer.size() - _start);
+        return _buffer.size() - _start;
+    }
+
+    bool full() const
+    {
+        return _datagrams.size() >= max_datagrams;
+    }
+
+    // number of datagrams not sent yet
+    size_t pending() const
+    {
+        return _datagrams.size() - _sent;
+    }
+
+    // send the pending datagrams. return false on error (see errno), the failed datagram being the first pending one
+    bool send(int fd)
+    {
+        while (pending() > 0)
+        {
+            auto n = send_from(fd, _sent);
+            if (n <= 0)
+            {
+                return false;
+            }
+            _sent += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    // skip the first pending datagram (e.g. one which cannot be sent)
+    void drop_first()
+    {
+        ++_sent;
+    }
+
+    void clear()
+    {
+        _datagrams.clear();
+        _buffer.clear();
+        _sent = 0;
+    }
+
+private:
+    int send_from(int fd, size_t first)
+    {
+        auto count = _datagrams.size() - first;
+#ifdef __linux__
+        if (count > 1)
+        {
+            struct iovec iov[max_datagrams];
+            struct mmsghdr msgs[max_datagrams];
+            if (count > max_datagrams)
+            {
+                count = max_datagrams;
+            }
+            std::memset(msgs, 0, sizeof(msgs[0]) * count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                iov[i].iov_base = const_cast<char *>(_buffer.data()) + _datagrams[first + i].first;
+                iov[i].iov_len = _datagrams[first + i].second;
+                msgs[i].msg_hdr.msg_iov = &iov[i];
+                msgs[i].msg_hdr.msg_iovlen = 1;
+            }
+            return ::sendmmsg(fd, msgs, static_cast<unsigned>(count), 0);
+        }
+#endif
+        (void)count;
+        auto &datagram = _datagrams[first];
+        return ::send(fd, _buffer.data() + datagram.first, datagram.second, 0) == -1 ? -1 : 1;
+    }
+
+    fmt::MemoryWriter _buffer;
+    // (offset, size) of each datagram in _buffer
+    std::vector<std::pair<size_t, size_t>> _datagrams;
+    size_t _sent{0};
+    size_t _start{0};
+};
+
+} // namespace details
+} // namespace spdlog
+
+#endif // _WIN32
@@ -0,0 +1,109 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+#pragma once
+
+// Helper threads running the tasks of a job at the same time: run(n, fun) calls fun(0) ... fun(n - 1), spread over
+// the helpers and the calling thread, and returns once all the calls returned.
+// Used by the async logger's worker to pass a batch of messages to its sinks in parallel (one task per sink).
+// The tasks are few and long (a sink writing a batch), so they are handed out under a mutex.
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace spdlog {
+namespace details {
+
+class dispatch_pool
+{
+public:
+    explicit dispatch_pool(size_t threads)
+    {
+        for (size_t i = 0; i < threads; i++)
+        {
+            _threads.emplace_back(&dispatch_pool::_helper_loop, this);
+        }
+    }
+
+    ~dispatch_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _start_cv.notify_all();
+        for (auto &t : _threads)
+        {
+            t.join();
+        }
+    }
+
+    dispatch_pool(const dispatch_pool &) = delete;
+    dispatch_pool &operator=(const dispatch_pool &) = delete;
+
+    // fun must not throw
+    void run(size_t tasks, const std::function<void(size_t)> &fun)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _fun = &fun;
+        _tasks = tasks;
+        _next = 0;
+        _pending = tasks;
+        _start_cv.notify_all();
+        _work(lock);
+        _done_cv.wait(lock, [this] { return _pending == 0; });
+        _tasks = 0;
+        _next = 0;
+        _fun = nullptr;
+    }
+
+private:
+    // run the tasks not started yet. called with the lock held.
+    void _work(std::unique_lock<std::mutex> &lock)
+    {
+        while (_next < _tasks)
+        {
+            auto task = _next++;
+            auto fun = _fun;
+            lock.unlock();
+            (*fun)(task);
+            lock.lock();
+            if (--_pending == 0)
+            {
+                _done_cv.notify_all();
+            }
+        }
+    }
+
+    void _helper_loop()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        for (;;)
+        {
+            _start_cv.wait(lock, [this] { return _stop || _next < _tasks; });
+            if (_stop)
+            {
+                return;
+            }
+            _work(lock);
+        }
+    }
+
+    std::mutex _mutex;
+    std::condition_variable _start_cv;
+    std::condition_variable _done_cv;
+    const std::function<void(size_t)> *_fun{nullptr};
+    size_t _tasks{0};
+    size_t _next{0};
+    size_t _pending{0};
+    bool _stop{false};
+    std::vector<std::thread> _threads;
+};
+
+} // namespace details
+} // namespace spdlog
@@ -82,9 +82,12 @@ public:
 
     void write(const log_msg &msg)
     {
-        size_t msg_size = msg.formatted.size();
-        auto data = msg.formatted.data();
-        if (std::fwrite(data, 1, msg_size, _fd) != msg_size)
+        write(msg.formatted.data(), msg.formatted.size());
+    }
+
+    void write(const char *data, size_t size)
+    {
+        if (std::fwrite(data, 1, size, _fd) != size)
         {
             throw spdlog_ex("Failed writing to file " + os::filename_to_str(_filename), errno);
         }
@@ -0,0 +1,108 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+#pragma once
+
+// Parser of level specs like "info,net=debug,net.http.client=trace", as read from the SPDLOG_LEVEL environment
+// variable or a level control file (see level_file_watcher.h).
+//
+// Entries are separated by ',' or new lines. "name=level" sets the level of a logger and the loggers below it
+// (see logger_tree.h), a level without a name sets the global level. '#' starts a comment running to the end of line.
+
+#include "../common.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace spdlog {
+namespace details {
+
+using level_config = std::vector<std::pair<std::string, level::level_enum>>;
+
+// the level names as printed by %l, and "warn" and "err"
+inline level::level_enum level_from_name(const std::string &name)
+{
+    for (int i = level::trace; i <= level::off; i++)
+    {
+        if (name == level::level_names[i])
+        {
+            return static_cast<level::level_enum>(i);
+        }
+    }
+    if (name == "warn")
+    {
+        return level::warn;
+    }
+    if (name == "err")
+    {
+        return level::err;
+    }
+    throw spdlog_ex("invalid level '" + name + "'");
+}
+
+inline std::string trim_spaces(const std::string &str)
+{
+    static const char *spaces = " \t\r";
+    auto first = str.find_first_not_of(spaces);
+    if (first == std::string::npos)
+    {
+        return std::string();
+    }
+    return str.substr(first, str.find_last_not_of(spaces) - first + 1);
+}
+
+// throws spdlog_ex if an entry is malformed
+inline level_config parse_level_config(const std::string &spec)
+{
+    level_config config;
+    size_t line_start = 0;
+    while (line_start < spec.size())
+    {
+        auto line_end = spec.find('\n', line_start);
+        if (line_end == std::string::npos)
+        {
+            line_end = spec.size();
+        }
+        auto line = spec.substr(line_start, line_end - line_start);
+        line = line.substr(0, line.find('#'));
+        line_start = line_end + 1;
+
+        size_t entry_start = 0;
+        while (entry_start <= line.size())
+        {
+            auto entry_end = line.find(',', entry_start);
+            if (entry_end == std::string::npos)
+            {
+                entry_end = line.size();
+            }
+            auto entry = trim_spaces(line.substr(entry_start, entry_end - entry_start));
+            entry_start = entry_end + 1;
+            if (entry.empty())
+            {
+                continue;
+            }
+
+            auto eq = entry.find('=');
+            if (eq == std::string::npos)
+            {
+                config.emplace_back(std::string(), level_from_name(entry));
+            }
+            else
+            {
+                auto logger_name = trim_spaces(entry.substr(0, eq));
+                if (logger_name.empty())
+                {
+                    throw spdlog_ex("missing logger name in level entry '" + entry + "'");
+                }
+                config.emplace_back(logger_name, level_from_name(trim_spaces(entry.substr(eq + 1))));
+            }
+        }
+    }
+    return config;
+}
+
+} // namespace details
+} // namespace spdlog
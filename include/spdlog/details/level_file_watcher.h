@@ -0,0 +1,234 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+#pragma once
+
+// Background thread watching a level control file (see spdlog::watch_level_file()).
+//
+// The callback is called with the file's content when watching starts and each time the content changes.
+// On Linux the thread sleeps in inotify on the file's directory, so editors replacing the file are noticed too,
+// and costs nothing until the file changes. Elsewhere (or if inotify is not available) the file is read every second.
+
+#include "../common.h"
+#include "../details/os.h"
+
+#include <cerrno>
+#include <condition_variable>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace spdlog {
+namespace details {
+
+class level_file_watcher
+{
+public:
+    using callback_t = std::function<void(const std::string &content)>;
+
+    level_file_watcher() = default;
+    level_file_watcher(const level_file_watcher &) = delete;
+    level_file_watcher &operator=(const level_file_watcher &) = delete;
+
+    ~level_file_watcher()
+    {
+        stop();
+    }
+
+    static level_file_watcher &instance()
+    {
+        static level_file_watcher s_instance;
+        return s_instance;
+    }
+
+    // watch the given file instead of the current one, if any. the callback is first called from this thread.
+    void watch(const filename_t &filename, callback_t on_change)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        stop_thread();
+        _filename = filename;
+        _on_change = std::move(on_change);
+        _content.clear();
+        _stop = false;
+#ifdef __linux__
+        // watch before the first read so no change can be missed
+        open_inotify();
+#endif
+        apply_if_changed();
+        _thread = std::thread(&level_file_watcher::thread_loop, this);
+    }
+
+    void stop()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        stop_thread();
+    }
+
+private:
+    void stop_thread()
+    {
+        if (!_thread.joinable())
+        {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(_stop_mutex);
+            _stop = true;
+        }
+        _stop_cv.notify_one();
+#ifdef __linux__
+        if (_stop_fd != -1)
+        {
+            uint64_t one = 1;
+            (void)::write(_stop_fd, &one, sizeof(one));
+        }
+#endif
+        _thread.join();
+#ifdef __linux__
+        close_inotify();
+#endif
+    }
+
+    void thread_loop()
+    {
+#ifdef __linux__
+        if (_inotify_fd != -1)
+        {
+            watch_inotify();
+            return;
+        }
+#endif
+        std::unique_lock<std::mutex> lock(_stop_mutex);
+        while (!_stop_cv.wait_for(lock, std::chrono::seconds(1), [this] { return _stop; }))
+        {
+            lock.unlock();
+            apply_if_changed();
+            lock.lock();
+        }
+    }
+
+#ifdef __linux__
+    // watch the file's directory. leaves both descriptors at -1 if inotify is not available.
+    void open_inotify()
+    {
+        auto slash = _filename.rfind('/');
+        auto dir = slash == filename_t::npos ? filename_t(".") : _filename.substr(0, slash + 1);
+        _inotify_fd = ::inotify_init1(IN_CLOEXEC);
+        _stop_fd = ::eventfd(0, EFD_CLOEXEC);
+        if (_inotify_fd == -1 || _stop_fd == -1 ||
+            ::inotify_add_watch(_inotify_fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) == -1)
+        {
+            close_inotify();
+        }
+    }
+
+    void close_inotify()
+    {
+        if (_inotify_fd != -1)
+        {
+            ::close(_inotify_fd);
+            _inotify_fd = -1;
+        }
+        if (_stop_fd != -1)
+        {
+            ::close(_stop_fd);
+            _stop_fd = -1;
+        }
+    }
+
+    void watch_inotify()
+    {
+        auto slash = _filename.rfind('/');
+        auto basename = slash == filename_t::npos ? _filename : _filename.substr(slash + 1);
+
+        alignas(inotify_event) char events[4096];
+        pollfd fds[2] = {{_inotify_fd, POLLIN, 0}, {_stop_fd, POLLIN, 0}};
+        for (;;)
+        {
+            if (::poll(fds, 2, -1) == -1)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return;
+            }
+            if (fds[1].revents != 0)
+            {
+                return;
+            }
+            if (fds[0].revents == 0)
+            {
+                continue;
+            }
+            auto len = ::read(_inotify_fd, events, sizeof(events));
+            bool changed = false;
+            for (ssize_t pos = 0; pos < len;)
+            {
+                auto event = reinterpret_cast<const inotify_event *>(events + pos);
+                changed |= event->len != 0 && basename == event->name;
+                pos += sizeof(inotify_event) + event->len;
+            }
+            if (changed)
+            {
+                apply_if_changed();
+            }
+        }
+    }
+#endif
+
+    // call the callback if the file can be read and its content changed since the last call.
+    // errors thrown by the callback are printed to stderr and the next change is waited for.
+    void apply_if_changed()
+    {
+        std::ifstream file(_filename);
+        if (!file)
+        {
+            return;
+        }
+        std::ostringstream content;
+        content << file.rdbuf();
+        if (content.str() == _content)
+        {
+            return;
+        }
+        _content = content.str();
+        try
+        {
+            _on_change(_content);
+        }
+        catch (const std::exception &ex)
+        {
+            fmt::print(stderr, "[*** LOG ERROR ***] [{}] {}\n", os::filename_to_str(_filename), ex.what());
+        }
+    }
+
+    std::mutex _mutex; // serializes watch() and stop()
+    std::thread _thread;
+    filename_t _filename;
+    callback_t _on_change;
+    std::string _content;
+
+    std::mutex _stop_mutex;
+    std::condition_variable _stop_cv;
+    bool _stop{false};
+#ifdef __linux__
+    int _inotify_fd{-1};
+    int _stop_fd{-1}; // eventfd waking the thread up on stop()
+#endif
+};
+
+} // namespace details
+} // namespace spdlog
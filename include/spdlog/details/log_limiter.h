@@ -0,0 +1,115 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+#pragma once
+
+// Rate limiting state of a log call site: every n-th call, at most once per interval, or a random sample.
+// All checks are lock free and done before the message is formatted, so suppressed calls cost a few nanoseconds.
+//
+// log_limiter: the state of one call site. The SPDLOG_<LEVEL>_EVERY_N/EVERY/SAMPLED macros keep a static one per site,
+//              callers of logger::log_every_n() and friends pass their own.
+
+#include "../common.h"
+#include "../details/os.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+namespace spdlog {
+namespace details {
+
+class log_limiter
+{
+public:
+    log_limiter() = default;
+    log_limiter(const log_limiter &) = delete;
+    log_limiter &operator=(const log_limiter &) = delete;
+
+    // let through the 1st, (n+1)th, (2n+1)th.. call
+    bool every_n(uint64_t n)
+    {
+        if (n <= 1 || _counter.fetch_add(1, std::memory_order_relaxed) % n == 0)
+        {
+            return true;
+        }
+        _suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // let through at most one call per interval (measured with a coarse clock)
+    template<typename Rep, typename Period>
+    bool every(const std::chrono::duration<Rep, Period> &interval)
+    {
+        auto now = os::coarse_steady_nanos();
+        auto next = _next_time.load(std::memory_order_relaxed);
+        if (now >= next &&
+            _next_time.compare_exchange_strong(next, now + std::chrono::duration_cast<std::chrono::nanoseconds>(interval).count(),
+                std::memory_order_relaxed))
+        {
+            return true;
+        }
+        _suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // let through each call with the given probability
+    bool sampled(double ratio)
+    {
+        if (ratio >= 1.0 || random_fraction() < ratio)
+        {
+            return true;
+        }
+        _suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // number of calls suppressed since the last call
+    uint64_t take_suppressed()
+    {
+        return _suppressed.load(std::memory_order_relaxed) == 0 ? 0 : _suppressed.exchange(0, std::memory_order_relaxed);
+    }
+
+private:
+    // splitmix64 over a per thread sequence
+    static double random_fraction()
+    {
+#ifndef SPDLOG_NO_TLS
+        static thread_local uint64_t state = std::hash<std::thread::id>()(std::this_thread::get_id()) ^
+                                             static_cast<uint64_t>(os::coarse_steady_nanos());
+        auto z = (state += 0x9E3779B97F4A7C15ULL);
+#else
+        static std::atomic<uint64_t> state{static_cast<uint64_t>(os::coarse_steady_nanos())};
+        auto z = state.fetch_add(0x9E3779B97F4A7C15ULL, std::memory_order_relaxed) + 0x9E3779B97F4A7C15ULL;
+#endif
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        z ^= z >> 31;
+        return static_cast<double>(z >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    std::atomic<uint64_t> _counter{0};
+    std::atomic<int64_t> _next_time{0};
+    std::atomic<uint64_t> _suppressed{0};
+};
+
+// log the number of calls the limiter suppressed since the last report, if any
+template<class Logger>
+inline void report_suppressed(Logger &logger, const source_loc &loc, level::level_enum lvl, log_limiter &limiter)
+{
+    auto suppressed = limiter.take_suppressed();
+    if (suppressed != 0)
+    {
+        logger.force_log(loc, lvl, fmt::format("{} similar messages suppressed", suppressed));
+    }
+}
+
+} // namespace details
+
+using log_limiter = details::log_limiter;
+
+} // namespace spdlog
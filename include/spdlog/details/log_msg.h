@@ -6,7 +6,11 @@
 #pragma once
 
 #include "../common.h"
+#include "../details/msg_buffer.h"
 #include "../details/os.h"
+#ifdef SPDLOG_CLOCK_TSC
+#include "../details/tsc_clock.h"
+#endif
 
 #include <string>
 #include <utility>
@@ -16,33 +20,80 @@ namespace details {
 struct log_msg
 {
     log_msg() = default;
-    log_msg(const std::string *loggers_name, level::level_enum lvl)
+    log_msg(const std::string *loggers_name, level::level_enum lvl, unsigned capture_flags = capture::all)
         : logger_name(loggers_name)
         , level(lvl)
     {
 #ifndef SPDLOG_NO_DATETIME
-        time = os::now();
+        if (capture_flags & capture::time)
+        {
+#ifdef SPDLOG_CLOCK_TSC
+            ticks = tsc_clock::ticks();
+#else
+            time = os::now();
+#endif
+        }
 #endif
 
 #ifndef SPDLOG_NO_THREAD_ID
-        thread_id = os::thread_id();
+        if (capture_flags & capture::thread_id)
+        {
+            thread_id = os::thread_id();
+        }
 #endif
+        (void)capture_flags;
+    }
+
+    // convert the captured clock ticks to time. done on the formatting side (e.g. by the async worker).
+    // no-op unless SPDLOG_CLOCK_TSC is defined
+    void resolve_time()
+    {
+#ifdef SPDLOG_CLOCK_TSC
+        if (ticks != 0)
+        {
+            time = tsc_clock::instance().to_time_point(ticks);
+        }
+#endif
+    }
+
+    // for messages kept beyond a log call (stored by a sink, reused by a worker thread): the text goes to buffers
+    // of the message's own instead of the thread's scratch buffers (see msg_buffer.h)
+    struct own_buffers_t
+    {
+    };
+
+    explicit log_msg(own_buffers_t)
+        : raw(false)
+        , formatted(false)
+    {
     }
 
     log_msg(const log_msg &other) = delete;
     log_msg &operator=(log_msg &&other) = delete;
     log_msg(log_msg &&other) = delete;
 
+    // hot fields first, to keep them in the first cache line
     const std::string *logger_name{nullptr};
-    level::level_enum level;
     log_clock::time_point time;
-    size_t thread_id;
-    fmt::MemoryWriter raw;
-    fmt::MemoryWriter formatted;
-    size_t msg_id{0};
+#ifdef SPDLOG_CLOCK_TSC
+    uint64_t ticks{0};
+#endif
+    size_t thread_id{0};
+    level::level_enum level;
     // wrap this range with color codes
     size_t color_range_start{0};
     size_t color_range_end{0};
+    size_t msg_id{0};
+    // format string and arguments the raw message was built from.
+    // valid only during the synchronous log call (not set for preformatted or async messages).
+    const char *fmt_str{nullptr};
+    fmt::ArgList fmt_args;
+    // source location of the log call, if known
+    const source_loc *source{nullptr};
+
+    // both are written to the calling thread's scratch buffers
+    scratch_writer raw;
+    scratch_writer formatted;
 };
 } // namespace details
 } // namespace spdlog
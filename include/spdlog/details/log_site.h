@@ -0,0 +1,242 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+#pragma once
+
+// Registry of log call sites.
+//
+// Each SPDLOG_<LEVEL> macro call site owns a static, constant initialized log_site.
+// On its first execution the site links itself into the registry's intrusive list and applies the
+// rules set so far (see spdlog::set_log_sites_by_file() and friends).
+// Afterwards checking the site costs a single relaxed load on top of the logger's level check.
+
+#include "../common.h"
+#include "../logger.h"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace spdlog {
+namespace details {
+
+// match str against a glob pattern ('*' matches any sequence of chars, '?' matches a single char)
+inline bool glob_match(const char *pattern, const char *str)
+{
+    const char *star = nullptr;
+    const char *star_str = nullptr;
+    while (*str != '\0')
+    {
+        if (*pattern == '*')
+        {
+            star = pattern++;
+            star_str = str;
+        }
+        else if (*pattern == '?' || *pattern == *str)
+        {
+            ++pattern;
+            ++str;
+        }
+        else if (star != nullptr)
+        {
+            pattern = star + 1;
+            str = ++star_str;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    while (*pattern == '*')
+    {
+        ++pattern;
+    }
+    return *pattern == '\0';
+}
+
+class log_site
+{
+public:
+    SPDLOG_CONSTEXPR log_site(const char *filename, int line, const char *funcname, level::level_enum lvl)
+        : loc(filename, line, funcname)
+        , level(lvl)
+    {
+    }
+
+    log_site(const log_site &) = delete;
+    log_site &operator=(const log_site &) = delete;
+
+    // whether a message from this site should be passed to the logger
+    bool should_log(const logger &logger)
+    {
+        switch (_state.load(std::memory_order_relaxed))
+        {
+        case state_follow_level:
+            return logger.should_log(level);
+        case state_enabled:
+            return true;
+        case state_disabled:
+            return false;
+        default:
+            register_site(logger);
+            return should_log(logger);
+        }
+    }
+
+    const source_loc loc;
+    const level::level_enum level;
+
+private:
+    friend class log_site_registry;
+
+    enum : int
+    {
+        state_unregistered = 0,
+        state_follow_level = 1,
+        state_enabled = 2,
+        state_disabled = 3
+    };
+
+    static int to_state(log_site_state state)
+    {
+        switch (state)
+        {
+        case log_site_state::enabled:
+            return state_enabled;
+        case log_site_state::disabled:
+            return state_disabled;
+        default:
+            return state_follow_level;
+        }
+    }
+
+    void register_site(const logger &logger);
+
+    std::atomic<int> _state{state_unregistered};
+    // owned by log_site_registry and guarded by its mutex
+    log_site *_next{nullptr};
+    const std::string *_logger_name{nullptr};
+};
+
+class log_site_registry
+{
+public:
+    log_site_registry(const log_site_registry &) = delete;
+    log_site_registry &operator=(const log_site_registry &) = delete;
+
+    static log_site_registry &instance()
+    {
+        static log_site_registry s_instance;
+        return s_instance;
+    }
+
+    // link the site into the list, recording the logger it is first used with, and apply the rules to it
+    void add(log_site &site, const std::string &logger_name)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (site._state.load(std::memory_order_relaxed) != log_site::state_unregistered)
+        {
+            return; // registered by another thread meanwhile
+        }
+        site._logger_name = &*_logger_names.insert(logger_name).first;
+        site._next = _head;
+        _head = &site;
+        int state = log_site::state_follow_level;
+        for (auto &r : _rules)
+        {
+            if (r.matches(site))
+            {
+                state = r.state;
+            }
+        }
+        site._state.store(state, std::memory_order_relaxed);
+    }
+
+    void set_by_file(const std::string &file_glob, log_site_state state)
+    {
+        add_rule(rule::by_file, file_glob, state);
+    }
+
+    void set_by_function(const std::string &function_glob, log_site_state state)
+    {
+        add_rule(rule::by_function, function_glob, state);
+    }
+
+    void set_by_logger(const std::string &logger_glob, log_site_state state)
+    {
+        add_rule(rule::by_logger, logger_glob, state);
+    }
+
+    // drop all rules. all sites follow their logger's level again.
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _rules.clear();
+        for (auto site = _head; site != nullptr; site = site->_next)
+        {
+            site->_state.store(log_site::state_follow_level, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    struct rule
+    {
+        enum kind_t
+        {
+            by_file,
+            by_function,
+            by_logger
+        };
+
+        kind_t kind;
+        std::string glob;
+        int state;
+
+        bool matches(const log_site &site) const
+        {
+            switch (kind)
+            {
+            case by_file:
+                return glob_match(glob.c_str(), site.loc.filename) || glob_match(glob.c_str(), site.loc.basename);
+            case by_function:
+                return glob_match(glob.c_str(), site.loc.funcname);
+            default:
+                return glob_match(glob.c_str(), site._logger_name->c_str());
+            }
+        }
+    };
+
+    log_site_registry() = default;
+
+    // rules are kept to be applied to sites registered later. later rules take precedence.
+    void add_rule(rule::kind_t kind, const std::string &glob, log_site_state state)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        rule r{kind, glob, log_site::to_state(state)};
+        for (auto site = _head; site != nullptr; site = site->_next)
+        {
+            if (r.matches(*site))
+            {
+                site->_state.store(r.state, std::memory_order_relaxed);
+            }
+        }
+        _rules.push_back(std::move(r));
+    }
+
+    std::mutex _mutex;
+    log_site *_head{nullptr};
+    std::vector<rule> _rules;
+    std::unordered_set<std::string> _logger_names;
+};
+
+inline void log_site::register_site(const logger &logger)
+{
+    log_site_registry::instance().add(*this, logger.name());
+}
+
+} // namespace details
+} // namespace spdlog
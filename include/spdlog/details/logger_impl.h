@@ -23,6 +23,7 @@ inline spdlog::logger::logger(std::string logger_name, const It &begin, const It
     , _msg_counter(1) // message counter will start from 1. 0-message id will be reserved for controll messages
 {
     _err_handler = [this](const std::string &msg) { this->_default_err_handler(msg); };
+    _formatter_changed();
 }
 
 // ctor with sinks as init list
@@ -52,19 +53,78 @@ inline void spdlog::logger::set_pattern(const std::string &pattern, pattern_time
 template<typename... Args>
 inline void spdlog::logger::log(level::level_enum lvl, const char *fmt, const Args &... args)
 {
-    if (!should_log(lvl))
+    log(source_loc{}, lvl, fmt, args...);
+}
+
+template<typename... Args>
+inline void spdlog::logger::log(level::level_enum lvl, const char *msg)
+{
+    log(source_loc{}, lvl, msg);
+}
+
+template<typename T>
+inline void spdlog::logger::log(level::level_enum lvl, const T &msg)
+{
+    log(source_loc{}, lvl, msg);
+}
+
+template<typename... Args>
+inline void spdlog::logger::log(const source_loc &loc, level::level_enum lvl, const char *fmt, const Args &... args)
+{
+    if (should_log(lvl))
     {
-        return;
+        force_log(loc, lvl, fmt, args...);
+    }
+    else if (_backtracer)
+    {
+        push_backtrace(loc, lvl, fmt, args...);
+    }
+}
+
+template<typename... Args>
+inline void spdlog::logger::log(const source_loc &loc, level::level_enum lvl, const char *msg)
+{
+    if (should_log(lvl))
+    {
+        force_log(loc, lvl, msg);
+    }
+    else if (_backtracer)
+    {
+        push_backtrace(loc, lvl, msg);
     }
+}
 
+template<typename T>
+inline void spdlog::logger::log(const source_loc &loc, level::level_enum lvl, const T &msg)
+{
+    if (should_log(lvl))
+    {
+        force_log(loc, lvl, msg);
+    }
+    else if (_backtracer)
+    {
+        push_backtrace(loc, lvl, msg);
+    }
+}
+
+template<typename... Args>
+inline void spdlog::logger::force_log(const source_loc &loc, level::level_enum lvl, const char *fmt, const Args &... args)
+{
     try
     {
-        details::log_msg log_msg(&_name, lvl);
+        _dump_backtrace_on(lvl);
+        details::log_msg log_msg(&_name, lvl, _capture_flags.load(std::memory_order_relaxed));
+        log_msg.source = &loc;
 
 #if defined(SPDLOG_FMT_PRINTF)
         fmt::printf(log_msg.raw, fmt, args...);
 #else
-        log_msg.raw.write(fmt, args...);
+        // keep the packed arguments around so sinks (e.g. binary_file_sink) can store them unformatted
+        using arg_array = fmt::internal::ArgArray<sizeof...(Args)>;
+        typename arg_array::Type arg_values{arg_array::template make<fmt::BasicFormatter<char>>(args)...};
+        log_msg.fmt_str = fmt;
+        log_msg.fmt_args = fmt::ArgList(fmt::internal::make_type(args...), arg_values);
+        log_msg.raw.write(fmt, log_msg.fmt_args);
 #endif
         _sink_it(log_msg);
     }
@@ -72,33 +132,66 @@ inline void spdlog::logger::log(level::level_enum lvl, const char *fmt, const Ar
 }
 
 template<typename... Args>
-inline void spdlog::logger::log(level::level_enum lvl, const char *msg)
+inline void spdlog::logger::force_log(const source_loc &loc, level::level_enum lvl, const char *msg)
 {
-    if (!should_log(lvl))
+    try
     {
-        return;
+        _dump_backtrace_on(lvl);
+        details::log_msg log_msg(&_name, lvl, _capture_flags.load(std::memory_order_relaxed));
+        log_msg.source = &loc;
+        log_msg.fmt_str = msg;
+        log_msg.raw << msg;
+        _sink_it(log_msg);
     }
+    SPDLOG_CATCH_AND_HANDLE
+}
+
+template<typename T>
+inline void spdlog::logger::force_log(const source_loc &loc, level::level_enum lvl, const T &msg)
+{
     try
     {
-        details::log_msg log_msg(&_name, lvl);
+        _dump_backtrace_on(lvl);
+        details::log_msg log_msg(&_name, lvl, _capture_flags.load(std::memory_order_relaxed));
+        log_msg.source = &loc;
         log_msg.raw << msg;
         _sink_it(log_msg);
     }
     SPDLOG_CATCH_AND_HANDLE
 }
 
-template<typename T>
-inline void spdlog::logger::log(level::level_enum lvl, const T &msg)
+template<typename... Args>
+inline void spdlog::logger::push_backtrace(const source_loc &loc, level::level_enum lvl, const char *fmt, const Args &... args)
 {
-    if (!should_log(lvl))
+    try
     {
-        return;
+#if defined(SPDLOG_FMT_PRINTF)
+        details::scratch_writer w;
+        fmt::printf(w, fmt, args...);
+        _backtracer->push_text(loc, lvl, w.data(), w.size());
+#else
+        using arg_array = fmt::internal::ArgArray<sizeof...(Args)>;
+        typename arg_array::Type arg_values{arg_array::template make<fmt::BasicFormatter<char>>(args)...};
+        _backtracer->push(loc, lvl, fmt, fmt::ArgList(fmt::internal::make_type(args...), arg_values));
+#endif
     }
+    SPDLOG_CATCH_AND_HANDLE
+}
+
+template<typename... Args>
+inline void spdlog::logger::push_backtrace(const source_loc &loc, level::level_enum lvl, const char *msg)
+{
+    _backtracer->push(loc, lvl, msg, fmt::ArgList());
+}
+
+template<typename T>
+inline void spdlog::logger::push_backtrace(const source_loc &loc, level::level_enum lvl, const T &msg)
+{
     try
     {
-        details::log_msg log_msg(&_name, lvl);
-        log_msg.raw << msg;
-        _sink_it(log_msg);
+        details::scratch_writer w;
+        w << msg;
+        _backtracer->push_text(loc, lvl, w.data(), w.size());
     }
     SPDLOG_CATCH_AND_HANDLE
 }
@@ -139,6 +232,56 @@ inline void spdlog::logger::critical(const char *fmt, const Arg1 &arg1, const Ar
     log(level::critical, fmt, arg1, args...);
 }
 
+template<typename... Args>
+inline void spdlog::logger::log_every_n(log_limiter &limiter, level::level_enum lvl, size_t n, const char *fmt, const Args &... args)
+{
+    if (should_log(lvl) && limiter.every_n(n))
+    {
+        force_log(source_loc{}, lvl, fmt, args...);
+        details::report_suppressed(*this, source_loc{}, lvl, limiter);
+    }
+}
+
+template<typename Rep, typename Period, typename... Args>
+inline void spdlog::logger::log_every(log_limiter &limiter, level::level_enum lvl, const std::chrono::duration<Rep, Period> &interval,
+    const char *fmt, const Args &... args)
+{
+    if (should_log(lvl) && limiter.every(interval))
+    {
+        force_log(source_loc{}, lvl, fmt, args...);
+        details::report_suppressed(*this, source_loc{}, lvl, limiter);
+    }
+}
+
+template<typename... Args>
+inline void spdlog::logger::log_sampled(log_limiter &limiter, level::level_enum lvl, double ratio, const char *fmt, const Args &... args)
+{
+    if (should_log(lvl) && limiter.sampled(ratio))
+    {
+        force_log(source_loc{}, lvl, fmt, args...);
+        details::report_suppressed(*this, source_loc{}, lvl, limiter);
+    }
+}
+
+template<typename... Args>
+inline void spdlog::logger::warn_every_n(log_limiter &limiter, size_t n, const char *fmt, const Args &... args)
+{
+    log_every_n(limiter, level::warn, n, fmt, args...);
+}
+
+template<typename Rep, typename Period, typename... Args>
+inline void spdlog::logger::warn_every(
+    log_limiter &limiter, const std::chrono::duration<Rep, Period> &interval, const char *fmt, const Args &... args)
+{
+    log_every(limiter, level::warn, interval, fmt, args...);
+}
+
+template<typename... Args>
+inline void spdlog::logger::warn_sampled(log_limiter &limiter, double ratio, const char *fmt, const Args &... args)
+{
+    log_sampled(limiter, level::warn, ratio, fmt, args...);
+}
+
 template<typename T>
 inline void spdlog::logger::trace(const T &msg)
 {
@@ -181,19 +324,49 @@ inline void spdlog::logger::critical(const T &msg)
 
 template<typename... Args>
 inline void spdlog::logger::log(level::level_enum lvl, const wchar_t *msg)
+{
+    log(source_loc{}, lvl, msg);
+}
+
+template<typename... Args>
+inline void spdlog::logger::log(level::level_enum lvl, const wchar_t *fmt, const Args &... args)
+{
+    log(source_loc{}, lvl, fmt, args...);
+}
+
+template<typename... Args>
+inline void spdlog::logger::log(const source_loc &loc, level::level_enum lvl, const wchar_t *msg)
+{
+    if (should_log(lvl))
+    {
+        force_log(loc, lvl, msg);
+    }
+}
+
+template<typename... Args>
+inline void spdlog::logger::log(const source_loc &loc, level::level_enum lvl, const wchar_t *fmt, const Args &... args)
+{
+    if (should_log(lvl))
+    {
+        force_log(loc, lvl, fmt, args...);
+    }
+}
+
+template<typename... Args>
+inline void spdlog::logger::force_log(const source_loc &loc, level::level_enum lvl, const wchar_t *msg)
 {
     std::wstring_convert<std::codecvt_utf8<wchar_t>> conv;
 
-    log(lvl, conv.to_bytes(msg));
+    force_log(loc, lvl, conv.to_bytes(msg));
 }
 
 template<typename... Args>
-inline void spdlog::logger::log(level::level_enum lvl, const wchar_t *fmt, const Args &... args)
+inline void spdlog::logger::force_log(const source_loc &loc, level::level_enum lvl, const wchar_t *fmt, const Args &... args)
 {
     fmt::WMemoryWriter wWriter;
 
     wWriter.write(fmt, args...);
-    log(lvl, wWriter.c_str());
+    force_log(loc, lvl, wWriter.c_str());
 }
 
 template<typename... Args>
@@ -280,14 +453,9 @@ inline void spdlog::logger::_sink_it(details::log_msg &msg)
 #if defined(SPDLOG_ENABLE_MESSAGE_COUNTER)
     _incr_msg_counter(msg);
 #endif
+    msg.resolve_time();
     _formatter->format(msg);
-    for (auto &sink : _sinks)
-    {
-        if (sink->should_log(msg.level))
-        {
-            sink->log(msg);
-        }
-    }
+    _sink_dispatch.for_each(msg.level, [&msg](sinks::sink &sink) { sink.log(msg); });
 
     if (_should_flush_on(msg))
     {
@@ -298,11 +466,13 @@ inline void spdlog::logger::_sink_it(details::log_msg &msg)
 inline void spdlog::logger::_set_pattern(const std::string &pattern, pattern_time_type pattern_time)
 {
     _formatter = std::make_shared<pattern_formatter>(pattern, pattern_time);
+    _formatter_changed();
 }
 
 inline void spdlog::logger::_set_formatter(formatter_ptr msg_formatter)
 {
     _formatter = std::move(msg_formatter);
+    _formatter_changed();
 }
 
 inline void spdlog::logger::flush()
@@ -331,6 +501,42 @@ inline void spdlog::logger::_default_err_handler(const std::string &msg)
     fmt::print(stderr, "[*** LOG ERROR ***] [{}] [{}] {}\n", date_buf, name(), msg);
 }
 
+inline void spdlog::logger::enable_backtrace(size_t n_messages, level::level_enum trigger_level)
+{
+    _backtracer.reset(new details::backtracer(n_messages, trigger_level));
+}
+
+inline void spdlog::logger::disable_backtrace()
+{
+    _backtracer.reset();
+}
+
+inline void spdlog::logger::dump_backtrace()
+{
+    if (!_backtracer)
+    {
+        return;
+    }
+    try
+    {
+        _backtracer->dump(&_name, [this](details::log_msg &msg) { _sink_it(msg); }, _err_handler);
+    }
+    SPDLOG_CATCH_AND_HANDLE
+}
+
+inline bool spdlog::logger::should_backtrace() const
+{
+    return _backtracer != nullptr;
+}
+
+inline void spdlog::logger::_dump_backtrace_on(level::level_enum lvl)
+{
+    if (_backtracer && lvl >= _backtracer->trigger_level())
+    {
+        dump_backtrace();
+    }
+}
+
 inline bool spdlog::logger::_should_flush_on(const details::log_msg &msg)
 {
     const auto flush_level = _flush_level.load(std::memory_order_relaxed);
@@ -342,6 +548,17 @@ inline void spdlog::logger::_incr_msg_counter(details::log_msg &msg)
     msg.msg_id = _msg_counter.fetch_add(1, std::memory_order_relaxed);
 }
 
+inline void spdlog::logger::_formatter_changed()
+{
+    unsigned flags = _formatter->capture_flags();
+    for (auto &sink : _sinks)
+    {
+        sink->set_formatter(_formatter);
+        flags |= sink->capture_flags();
+    }
+    _capture_flags.store(flags, std::memory_order_relaxed);
+}
+
 inline const std::vector<spdlog::sink_ptr> &spdlog::logger::sinks() const
 {
     return _sinks;
@@ -0,0 +1,250 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+#pragma once
+
+// Hierarchy of the registered loggers by their dotted names.
+// "net.http.client" is a child of "net.http", which is a child of "net", which is a child of the root ("").
+//
+// The level and flush level set on a node apply to the loggers of its whole subtree, except below nodes which set
+// their own. Each node caches the nearest node configuring each setting (itself included) and keeps the list of its
+// children, so a change only walks the affected subtree and the logger's level check stays a single atomic load.
+// Sinks are resolved once, when a logger is created by the registry's get_or_create().
+// A logger registered with register_logger() keeps the levels it was given, until a level is set above it.
+// Nodes without a logger, settings or children are removed when their logger is dropped.
+//
+// Not thread safe: guarded by the registry's mutex.
+
+#include "../common.h"
+#include "../logger.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace spdlog {
+namespace details {
+
+class logger_tree
+{
+public:
+    logger_tree()
+    {
+        _nodes[""] = std::unique_ptr<node>(new node(nullptr));
+    }
+
+    logger_tree(const logger_tree &) = delete;
+    logger_tree &operator=(const logger_tree &) = delete;
+
+    // attach a newly registered logger to its node. apply_levels: apply the levels configured above it, if any.
+    void attach(const std::string &logger_name, logger *new_logger, bool apply_levels)
+    {
+        auto &n = find_or_add(logger_name);
+        n.registered = new_logger;
+        if (apply_levels)
+        {
+            apply(n);
+        }
+    }
+
+    void detach(const std::string &logger_name)
+    {
+        auto found = _nodes.find(logger_name);
+        if (found != _nodes.end())
+        {
+            found->second->registered = nullptr;
+            prune(logger_name);
+        }
+    }
+
+    void detach_all()
+    {
+        std::vector<std::string> names;
+        for (auto &n : _nodes)
+        {
+            n.second->registered = nullptr;
+            names.push_back(n.first);
+        }
+        for (auto &name : names)
+        {
+            prune(name);
+        }
+    }
+
+    // number of nodes, the root included
+    size_t size() const
+    {
+        return _nodes.size();
+    }
+
+    void set_level(const std::string &logger_name, level::level_enum log_level)
+    {
+        auto &n = find_or_add(logger_name);
+        n.level = log_level;
+        n.has_level = true;
+        propagate(n, &node::has_level, &node::level_source, &n);
+    }
+
+    void flush_on(const std::string &logger_name, level::level_enum log_level)
+    {
+        auto &n = find_or_add(logger_name);
+        n.flush_level = log_level;
+        n.has_flush_level = true;
+        propagate(n, &node::has_flush_level, &node::flush_source, &n);
+    }
+
+    // set the level of the root and drop the levels set below it
+    void set_level_all(level::level_enum log_level)
+    {
+        for (auto &n : _nodes)
+        {
+            n.second->has_level = false;
+        }
+        set_level("", log_level);
+    }
+
+    // set the flush level of the root and drop the flush levels set below it
+    void flush_on_all(level::level_enum log_level)
+    {
+        for (auto &n : _nodes)
+        {
+            n.second->has_flush_level = false;
+        }
+        flush_on("", log_level);
+    }
+
+    void set_sinks(const std::string &logger_name, std::vector<sink_ptr> sinks)
+    {
+        auto &n = find_or_add(logger_name);
+        n.sinks = std::move(sinks);
+        n.has_sinks = true;
+    }
+
+    // sinks for a new logger: those set on the nearest ancestor by set_sinks(), or used by its registered logger
+    std::vector<sink_ptr> inherited_sinks(const std::string &logger_name)
+    {
+        for (auto n = &find_or_add(logger_name); n != nullptr; n = n->parent)
+        {
+            if (n->has_sinks)
+            {
+                return n->sinks;
+            }
+            if (n->registered != nullptr && !n->registered->sinks().empty())
+            {
+                return n->registered->sinks();
+            }
+        }
+        return {};
+    }
+
+private:
+    struct node
+    {
+        explicit node(node *parent_node)
+            : parent(parent_node)
+        {
+            if (parent != nullptr)
+            {
+                level_source = parent->level_source;
+                flush_source = parent->flush_source;
+                parent->children.push_back(this);
+            }
+        }
+
+        node *parent;
+        std::vector<node *> children;
+        logger *registered{nullptr};
+
+        // configured on this node
+        bool has_level{false};
+        bool has_flush_level{false};
+        bool has_sinks{false};
+        level::level_enum level{level::info};
+        level::level_enum flush_level{level::off};
+        std::vector<sink_ptr> sinks;
+
+        // nearest node configuring the setting on the path to the root, nullptr if none
+        const node *level_source{nullptr};
+        const node *flush_source{nullptr};
+    };
+
+    static std::string parent_name(const std::string &logger_name)
+    {
+        auto dot = logger_name.rfind('.');
+        return dot == std::string::npos ? std::string() : logger_name.substr(0, dot);
+    }
+
+    node &find_or_add(const std::string &logger_name)
+    {
+        auto found = _nodes.find(logger_name);
+        if (found != _nodes.end())
+        {
+            return *found->second;
+        }
+        auto &parent = find_or_add(parent_name(logger_name));
+        auto &n = _nodes[logger_name];
+        n.reset(new node(&parent));
+        return *n;
+    }
+
+    // remove the node if it holds nothing, then its ancestors which hold nothing else
+    void prune(std::string logger_name)
+    {
+        while (!logger_name.empty())
+        {
+            auto found = _nodes.find(logger_name);
+            if (found == _nodes.end())
+            {
+                return;
+            }
+            auto &n = *found->second;
+            if (n.registered != nullptr || n.has_level || n.has_flush_level || n.has_sinks || !n.children.empty())
+            {
+                return;
+            }
+            auto &siblings = n.parent->children;
+            siblings.erase(std::find(siblings.begin(), siblings.end(), &n));
+            _nodes.erase(found);
+            logger_name = parent_name(logger_name);
+        }
+    }
+
+    // set the source of a setting in the subtree of n, skipping the subtrees which configure it themselves
+    void propagate(node &n, bool node::*has_setting, const node *node::*source, const node *new_source)
+    {
+        n.*source = new_source;
+        apply(n);
+        for (auto child : n.children)
+        {
+            if (!(child->*has_setting))
+            {
+                propagate(*child, has_setting, source, new_source);
+            }
+        }
+    }
+
+    static void apply(const node &n)
+    {
+        if (n.registered == nullptr)
+        {
+            return;
+        }
+        if (n.level_source != nullptr)
+        {
+            n.registered->set_level(n.level_source->level);
+        }
+        if (n.flush_source != nullptr)
+        {
+            n.registered->flush_on(n.flush_source->flush_level);
+        }
+    }
+
+    std::unordered_map<std::string, std::unique_ptr<node>> _nodes;
+};
+
+} // namespace details
+} // namespace spdlog
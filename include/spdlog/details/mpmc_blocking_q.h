@@ -10,6 +10,7 @@
 // enqueue(..) - will block until room found to put the new message
 // enqueue_nowait(..) - will return immediatly with false if no room left in the queue
 // dequeue_for(..) - will block until the queue is not empty or timeout passed
+// size() - number of items waiting in the queue
 
 #include <condition_variable>
 #include <mutex>
@@ -72,6 +73,13 @@ public:
         return true;
     }
 
+    // number of items in the queue
+    size_t size()
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        return q_.size();
+    }
+
 private:
     size_t max_items_;
     std::mutex queue_mutex_;
@@ -0,0 +1,147 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+#pragma once
+
+// Writer holding the raw and formatted text of log_msg.
+//
+// Borrows one of the calling thread's scratch buffers, which keep their capacity between log calls,
+// so formatting does not allocate in steady state, even for long messages. The buffer goes back to its thread when
+// the writer is destroyed, on whichever thread that happens.
+// Uses a buffer of its own (SPDLOG_MSG_INLINE_BUFFER_SIZE bytes, then growing) if all scratch buffers are
+// taken (e.g. logging from inside a sink), if thread local storage is not available, or if constructed with
+// use_scratch false: messages kept beyond a log call (stored by a sink or a worker thread) must not hold scratch
+// buffers, which are freed when their thread exits.
+// With thread local storage, the own buffer is not embedded, so a log_msg using scratch buffers stays small.
+
+#include "../details/os.h"
+#include "../fmt/fmt.h"
+
+#include <atomic>
+#include <memory>
+
+namespace spdlog {
+namespace details {
+
+// the writer's own buffer: a base class of the writer, so it is constructed before the fmt::Writer base using it.
+// embedded without thread local storage (always used then), allocated on demand otherwise.
+class own_buffer_holder
+{
+protected:
+    using own_buffer_type = fmt::internal::MemoryBuffer<char, SPDLOG_MSG_INLINE_BUFFER_SIZE>;
+
+    fmt::Buffer<char> &own_buffer()
+    {
+#ifdef SPDLOG_NO_TLS
+        return _own_buffer;
+#else
+        _own_buffer.reset(new own_buffer_type());
+        return *_own_buffer;
+#endif
+    }
+
+private:
+#ifdef SPDLOG_NO_TLS
+    own_buffer_type _own_buffer;
+#else
+    std::unique_ptr<own_buffer_type> _own_buffer;
+#endif
+};
+
+class scratch_writer SPDLOG_FINAL : private own_buffer_holder, public fmt::Writer
+{
+public:
+    // scratch buffers which grew beyond this size are freed after use
+    static const std::size_t max_retained_size = 1024 * 1024;
+
+    // per thread scratch buffers: enough for the raw and formatted text of one message
+    static const std::size_t scratch_slots = 2;
+
+    explicit scratch_writer(bool use_scratch = true)
+        : fmt::Writer(acquire(use_scratch, *this))
+        , _slot(slot_of(buffer()))
+    {
+    }
+
+    ~scratch_writer() override
+    {
+        if (_slot != nullptr)
+        {
+            if (_slot->buffer.capacity() > max_retained_size)
+            {
+                _slot->buffer = scratch_slot::buffer_type();
+            }
+            _slot->in_use.store(false, std::memory_order_release);
+        }
+    }
+
+    scratch_writer(const scratch_writer &) = delete;
+    scratch_writer &operator=(const scratch_writer &) = delete;
+
+private:
+    struct scratch_slot
+    {
+        using buffer_type = fmt::internal::MemoryBuffer<char, fmt::internal::INLINE_BUFFER_SIZE>;
+        buffer_type buffer;
+        // taken by a writer, possibly released from another thread
+        std::atomic<bool> in_use{false};
+    };
+
+#ifndef SPDLOG_NO_TLS
+
+    struct scratch_buffers
+    {
+        scratch_slot slots[scratch_slots];
+    };
+
+    static scratch_buffers &thread_scratch()
+    {
+        static thread_local scratch_buffers scratch;
+        return scratch;
+    }
+#endif
+
+    static fmt::Buffer<char> &acquire(bool use_scratch, scratch_writer &writer)
+    {
+#ifndef SPDLOG_NO_TLS
+        if (use_scratch)
+        {
+            for (auto &slot : thread_scratch().slots)
+            {
+                if (!slot.in_use.load(std::memory_order_acquire))
+                {
+                    slot.in_use.store(true, std::memory_order_relaxed);
+                    slot.buffer.clear();
+                    return slot.buffer;
+                }
+            }
+        }
+#endif
+        (void)use_scratch;
+        return writer.own_buffer();
+    }
+
+    // the scratch slot holding the given buffer, null for the writer's own buffer
+    static scratch_slot *slot_of(fmt::Buffer<char> &buf)
+    {
+#ifndef SPDLOG_NO_TLS
+        for (auto &slot : thread_scratch().slots)
+        {
+            if (&buf == static_cast<fmt::Buffer<char> *>(&slot.buffer))
+            {
+                return &slot;
+            }
+        }
+#endif
+        (void)buf;
+        return nullptr;
+    }
+
+    // released in the destructor, possibly on another thread than the owner of the slot
+    scratch_slot *_slot;
+};
+
+} // namespace details
+} // namespace spdlog
@@ -0,0 +1,117 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+#pragma once
+
+// Socket helpers for the network sinks (POSIX only)
+
+#ifndef _WIN32
+
+#include "../common.h"
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace spdlog {
+namespace details {
+namespace net {
+
+// a resolved socket address
+struct address
+{
+    sockaddr_storage storage;
+    socklen_t size{0};
+    int family{AF_UNSPEC};
+};
+
+// resolve host:port for the given socket type (SOCK_DGRAM or SOCK_STREAM). return false if it cannot be resolved.
+inline bool resolve(const std::string &host, int port, int socktype, address &addr)
+{
+    struct addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = socktype;
+    hints.ai_flags = AI_NUMERICSERV;
+    struct addrinfo *result = nullptr;
+    if (::getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &result) != 0 || result == nullptr)
+    {
+        return false;
+    }
+    std::memcpy(&addr.storage, result->ai_addr, result->ai_addrlen);
+    addr.size = static_cast<socklen_t>(result->ai_addrlen);
+    addr.family = result->ai_family;
+    ::freeaddrinfo(result);
+    return true;
+}
+
+// the address of a unix domain socket
+inline address unix_address(const std::string &path)
+{
+    address addr;
+    std::memset(&addr.storage, 0, sizeof(addr.storage));
+    auto un = reinterpret_cast<sockaddr_un *>(&addr.storage);
+    un->sun_family = AF_UNIX;
+    std::strncpy(un->sun_path, path.c_str(), sizeof(un->sun_path) - 1);
+    addr.size = sizeof(sockaddr_un);
+    addr.family = AF_UNIX;
+    return addr;
+}
+
+inline void close_socket(int &fd)
+{
+    if (fd != -1)
+    {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+// create a non blocking socket and start connecting it. return the socket, or -1 on error (see errno).
+// for stream sockets, the connection might still be in progress (see connect_completed()).
+inline int connect_nonblocking(const address &addr, int socktype)
+{
+    int fd = ::socket(addr.family, socktype, 0);
+    if (fd == -1)
+    {
+        return -1;
+    }
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+#ifdef SO_NOSIGPIPE
+    int on = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+    if (::connect(fd, reinterpret_cast<const sockaddr *>(&addr.storage), addr.size) == -1 && errno != EINPROGRESS)
+    {
+        auto err = errno;
+        close_socket(fd);
+        errno = err;
+        return -1;
+    }
+    return fd;
+}
+
+// flags for send() on stream sockets: a closed connection must not raise SIGPIPE
+#ifdef MSG_NOSIGNAL
+static const int send_flags = MSG_NOSIGNAL;
+#else
+static const int send_flags = 0;
+#endif
+
+} // namespace net
+} // namespace details
+} // namespace spdlog
+
+#endif // _WIN32
@@ -7,7 +7,9 @@
 #include "../common.h"
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -38,6 +40,7 @@
 #else // unix
 
 #include <fcntl.h>
+#include <pthread.h>
 #include <unistd.h>
 
 #ifdef __linux__
@@ -53,6 +56,11 @@
 #define __has_feature(x) 0 // Compatibility with non-clang compilers.
 #endif
 
+// thread_local support
+#if (defined(_MSC_VER) && (_MSC_VER < 1900)) || defined(__cplusplus_winrt) || (defined(__clang__) && !__has_feature(cxx_thread_local))
+#define SPDLOG_NO_TLS
+#endif
+
 namespace spdlog {
 namespace details {
 namespace os {
@@ -70,6 +78,20 @@ inline spdlog::log_clock::time_point now()
     return log_clock::now();
 #endif
 }
+
+// monotonic time in nanoseconds, at the resolution of the scheduler tick where a cheaper clock is available.
+// good enough for rate limiting.
+inline int64_t coarse_steady_nanos()
+{
+#if defined __linux__ && defined CLOCK_MONOTONIC_COARSE
+    timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
 inline std::tm localtime(const std::time_t &time_tt)
 {
 
@@ -347,8 +369,7 @@ inline size_t _thread_id()
 // Return current thread id as size_t (from thread local storage)
 inline size_t thread_id()
 {
-#if defined(SPDLOG_DISABLE_TID_CACHING) || (defined(_MSC_VER) && (_MSC_VER < 1900)) || defined(__cplusplus_winrt) ||                       \
-    (defined(__clang__) && !__has_feature(cxx_thread_local))
+#if defined(SPDLOG_DISABLE_TID_CACHING) || defined(SPDLOG_NO_TLS)
     return _thread_id();
 #else // cache thread id in tls
     static thread_local const size_t tid = _thread_id();
@@ -383,13 +404,35 @@ inline std::string filename_to_str(const filename_t &filename)
 }
 #endif
 
+#ifndef _WIN32
+inline std::atomic<int> &cached_pid()
+{
+    static std::atomic<int> pid{0};
+    return pid;
+}
+
+inline void reset_cached_pid()
+{
+    cached_pid().store(0, std::memory_order_relaxed);
+}
+#endif
+
+// Return current process id. Cached after the first call (the cache is reset in forked children).
 inline int pid()
 {
 
 #ifdef _WIN32
     return static_cast<int>(::GetCurrentProcessId());
 #else
-    return static_cast<int>(::getpid());
+    static const bool fork_handler_registered = ::pthread_atfork(nullptr, nullptr, reset_cached_pid) == 0;
+    (void)fork_handler_registered;
+    auto pid = cached_pid().load(std::memory_order_relaxed);
+    if (pid == 0)
+    {
+        pid = static_cast<int>(::getpid());
+        cached_pid().store(pid, std::memory_order_relaxed);
+    }
+    return pid;
 #endif
 }
 
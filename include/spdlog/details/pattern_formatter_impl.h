@@ -114,14 +114,14 @@ class B_formatter : public flag_formatter
 };
 
 // write 2 ints separated by sep with padding of 2
-static fmt::MemoryWriter &pad_n_join(fmt::MemoryWriter &w, int v1, int v2, char sep)
+static fmt::Writer &pad_n_join(fmt::Writer &w, int v1, int v2, char sep)
 {
     w << fmt::pad(v1, 2, '0') << sep << fmt::pad(v2, 2, '0');
     return w;
 }
 
 // write 3 ints separated by sep with padding of 2
-static fmt::MemoryWriter &pad_n_join(fmt::MemoryWriter &w, int v1, int v2, int v3, char sep)
+static fmt::Writer &pad_n_join(fmt::Writer &w, int v1, int v2, int v3, char sep)
 {
     w << fmt::pad(v1, 2, '0') << sep << fmt::pad(v2, 2, '0') << sep << fmt::pad(v3, 2, '0');
     return w;
@@ -378,6 +378,40 @@ class i_formatter SPDLOG_FINAL : public flag_formatter
     }
 };
 
+// Source location of the log call (empty if not known)
+class source_filename_formatter SPDLOG_FINAL : public flag_formatter
+{
+    void format(details::log_msg &msg, const std::tm &) override
+    {
+        if (msg.source != nullptr && !msg.source->empty())
+        {
+            msg.formatted << msg.source->basename;
+        }
+    }
+};
+
+class source_linenum_formatter SPDLOG_FINAL : public flag_formatter
+{
+    void format(details::log_msg &msg, const std::tm &) override
+    {
+        if (msg.source != nullptr && !msg.source->empty())
+        {
+            msg.formatted << msg.source->line;
+        }
+    }
+};
+
+class source_funcname_formatter SPDLOG_FINAL : public flag_formatter
+{
+    void format(details::log_msg &msg, const std::tm &) override
+    {
+        if (msg.source != nullptr && !msg.source->empty())
+        {
+            msg.formatted << msg.source->funcname;
+        }
+    }
+};
+
 class v_formatter SPDLOG_FINAL : public flag_formatter
 {
     void format(details::log_msg &msg, const std::tm &) override
@@ -487,6 +521,48 @@ class full_formatter SPDLOG_FINAL : public flag_formatter
     }
 };
 
+// log_msg fields needed by the given flag
+inline unsigned flag_capture_flags(char flag)
+{
+    switch (flag)
+    {
+    case ('t'):
+        return capture::thread_id;
+
+    case ('a'):
+    case ('A'):
+    case ('b'):
+    case ('h'):
+    case ('B'):
+    case ('c'):
+    case ('C'):
+    case ('Y'):
+    case ('D'):
+    case ('x'):
+    case ('m'):
+    case ('d'):
+    case ('H'):
+    case ('I'):
+    case ('M'):
+    case ('S'):
+    case ('e'):
+    case ('f'):
+    case ('F'):
+    case ('E'):
+    case ('p'):
+    case ('r'):
+    case ('R'):
+    case ('T'):
+    case ('X'):
+    case ('z'):
+    case ('+'):
+        return capture::time;
+
+    default:
+        return capture::none;
+    }
+}
+
 } // namespace details
 } // namespace spdlog
 ///////////////////////////////////////////////////////////////////////////////
@@ -537,6 +613,7 @@ inline void spdlog::pattern_formatter::compile_pattern(const std::string &patter
 }
 inline void spdlog::pattern_formatter::handle_flag(char flag)
 {
+    _capture_flags |= details::flag_capture_flags(flag);
     switch (flag)
     {
     // logger name
@@ -666,6 +743,18 @@ inline void spdlog::pattern_formatter::handle_flag(char flag)
         _formatters.emplace_back(new details::i_formatter());
         break;
 
+    case ('s'):
+        _formatters.emplace_back(new details::source_filename_formatter());
+        break;
+
+    case ('#'):
+        _formatters.emplace_back(new details::source_linenum_formatter());
+        break;
+
+    case ('!'):
+        _formatters.emplace_back(new details::source_funcname_formatter());
+        break;
+
     case ('^'):
         _formatters.emplace_back(new details::color_start_formatter());
         break;
@@ -690,13 +779,20 @@ inline std::tm spdlog::pattern_formatter::get_time(details::log_msg &msg)
     return details::os::gmtime(log_clock::to_time_t(msg.time));
 }
 
-inline void spdlog::pattern_formatter::format(details::log_msg &msg)
+inline unsigned spdlog::pattern_formatter::capture_flags() const
 {
+    return _capture_flags;
+}
 
+inline void spdlog::pattern_formatter::format(details::log_msg &msg)
+{
+    std::tm tm_time{};
 #ifndef SPDLOG_NO_DATETIME
-    auto tm_time = get_time(msg);
-#else
-    std::tm tm_time;
+    // skip the (relatively expensive) time conversion if the pattern has no date/time flags
+    if (_capture_flags & capture::time)
+    {
+        tm_time = get_time(msg);
+    }
 #endif
     for (auto &f : _formatters)
     {
@@ -0,0 +1,93 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+#pragma once
+
+// Minimal read-copy-update support for read mostly data.
+//
+// Readers enter a (short) read side section, load the published pointer and use it until they leave.
+// They never block and never take a lock.
+// Writers publish a new copy and call synchronize() before freeing the old one, which waits until all the readers
+// which could still see it have left. synchronize() calls are serialized by the domain, so writers may call it
+// after releasing their own lock.
+//
+// Readers are counted in one of two counters selected by the current epoch. synchronize() flips the epoch twice,
+// waiting each time for the counter of the previous epoch to drain, so new readers never delay it.
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+
+namespace spdlog {
+namespace details {
+
+class rcu_domain
+{
+public:
+    rcu_domain() = default;
+    rcu_domain(const rcu_domain &) = delete;
+    rcu_domain &operator=(const rcu_domain &) = delete;
+
+    // RAII read side section
+    class read_guard
+    {
+    public:
+        explicit read_guard(rcu_domain &domain)
+            : _domain(domain)
+            , _index(domain._epoch.load() & 1)
+        {
+            _domain._readers[_index].count.fetch_add(1);
+            // pairs with the fence in synchronize(): either the writer sees this reader, or this reader sees the
+            // pointer published before synchronize()
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+
+        ~read_guard()
+        {
+            _domain._readers[_index].count.fetch_sub(1, std::memory_order_release);
+        }
+
+        read_guard(const read_guard &) = delete;
+        read_guard &operator=(const read_guard &) = delete;
+
+    private:
+        rcu_domain &_domain;
+        unsigned _index;
+    };
+
+    // wait until every read side section which started before the call has ended
+    void synchronize()
+    {
+        std::lock_guard<std::mutex> lock(_synchronize_mutex);
+        for (int i = 0; i < 2; i++)
+        {
+            auto previous = _epoch.fetch_add(1) & 1;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            while (_readers[previous].count.load(std::memory_order_acquire) != 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    static const size_t cache_line_size = 64;
+
+    // keep the two counters on separate cache lines
+    struct padded_counter
+    {
+        std::atomic<size_t> count{0};
+        char pad[cache_line_size - sizeof(std::atomic<size_t>)];
+    };
+
+    std::atomic<unsigned> _epoch{0};
+    padded_counter _readers[2];
+    // the epoch flips of concurrent synchronize() calls must not interleave
+    std::mutex _synchronize_mutex;
+};
+
+} // namespace details
+} // namespace spdlog
@@ -9,20 +9,103 @@
 // An attempt to create a logger with an already existing name will be ignored
 // If user requests a non existing logger, nullptr will be returned
 // This class is thread safe
+//
+// Lookups (get() and logger_handle) are lock free: each registered name has an entry holding the current logger.
+// The name->entry map and the entries' loggers are published with read-copy-update (see rcu_domain.h).
+// Registering or dropping a logger copies the map and waits for the lookups in progress.
+// The entry of a dropped name is freed once no handle refers to it (after a grace period, with the old map).
+//
+// Loggers are also organized by their dotted names (see logger_tree.h): levels, flush levels and sinks
+// can be configured for a whole subtree.
 
 #include "../async_logger.h"
 #include "../common.h"
+#include "../details/level_config.h"
+#include "../details/logger_tree.h"
 #include "../details/null_mutex.h"
+#include "../details/rcu_domain.h"
 #include "../logger.h"
 
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace spdlog {
+namespace details {
+
+// the logger currently registered under a name. shared by the registry's map and the handles to the name.
+struct registry_entry
+{
+    explicit registry_entry(rcu_domain &domain)
+        : rcu(domain)
+    {
+    }
+
+    ~registry_entry()
+    {
+        delete logger.load();
+    }
+
+    registry_entry(const registry_entry &) = delete;
+    registry_entry &operator=(const registry_entry &) = delete;
+
+    // read the logger without locking. nullptr if none is registered.
+    std::shared_ptr<spdlog::logger> get() const
+    {
+        rcu_domain::read_guard guard(rcu);
+        auto current = logger.load(std::memory_order_acquire);
+        return current != nullptr ? *current : nullptr;
+    }
+
+    rcu_domain &rcu;
+    std::atomic<std::shared_ptr<spdlog::logger> *> logger{nullptr};
+};
+} // namespace details
+
+// Cheap, copyable reference to the logger registered under a name (see spdlog::get_handle()).
+// Resolving it does not hash the name or take any lock. Follows the name if the logger is dropped or replaced.
+// operator-> throws spdlog_ex while no logger is registered under the name: check the handle first (or use get())
+// where the logger may be missing.
+class logger_handle
+{
+public:
+    logger_handle() = default;
+    explicit logger_handle(std::shared_ptr<details::registry_entry> entry)
+        : _entry(std::move(entry))
+    {
+    }
+
+    // the logger currently registered under the name, or nullptr
+    std::shared_ptr<logger> get() const
+    {
+        return _entry != nullptr ? _entry->get() : nullptr;
+    }
+
+    // log through the handle, e.g. handle->info("hello"). throws spdlog_ex if no logger is registered under the name.
+    std::shared_ptr<logger> operator->() const
+    {
+        auto registered = get();
+        if (registered == nullptr)
+        {
+            throw spdlog_ex("logger_handle: no logger registered under this name");
+        }
+        return registered;
+    }
+
+    explicit operator bool() const
+    {
+        return get() != nullptr;
+    }
+
+private:
+    std::shared_ptr<details::registry_entry> _entry;
+};
+
 namespace details {
 template<class Mutex>
 class registry_t
@@ -31,19 +114,44 @@ public:
     registry_t<Mutex>(const registry_t<Mutex> &) = delete;
     registry_t<Mutex> &operator=(const registry_t<Mutex> &) = delete;
 
+    ~registry_t()
+    {
+        delete _entry_map.load();
+    }
+
     void register_logger(std::shared_ptr<logger> logger)
     {
         std::lock_guard<Mutex> lock(_mutex);
         auto logger_name = logger->name();
         throw_if_exists(logger_name);
-        _loggers[logger_name] = logger;
+        // keep the levels the caller set: only the levels set later above the logger apply to it
+        add(logger_name, std::move(logger), false);
     }
 
+    // lock free
     std::shared_ptr<logger> get(const std::string &logger_name)
+    {
+        rcu_domain::read_guard guard(_rcu);
+        auto entries = _entry_map.load(std::memory_order_acquire);
+        auto found = entries->find(logger_name);
+        if (found == entries->end())
+        {
+            return nullptr;
+        }
+        auto current = found->second->logger.load(std::memory_order_acquire);
+        return current != nullptr ? *current : nullptr;
+    }
+
+    // number of names with an entry: the registered loggers and the names handles refer to
+    size_t entries() const
+    {
+        return _entry_map.load(std::memory_order_acquire)->size();
+    }
+
+    logger_handle get_handle(const std::string &logger_name)
     {
         std::lock_guard<Mutex> lock(_mutex);
-        auto found = _loggers.find(logger_name);
-        return found == _loggers.end() ? nullptr : found->second;
+        return logger_handle(entry(logger_name));
     }
 
     template<class It>
@@ -51,33 +159,20 @@ public:
     {
         std::lock_guard<Mutex> lock(_mutex);
         throw_if_exists(logger_name);
-        std::shared_ptr<logger> new_logger;
-        if (_async_mode)
-        {
-            new_logger = std::make_shared<async_logger>(logger_name, sinks_begin, sinks_end, _async_q_size, _overflow_policy,
-                _worker_warmup_cb, _flush_interval_ms, _worker_teardown_cb);
-        }
-        else
-        {
-            new_logger = std::make_shared<logger>(logger_name, sinks_begin, sinks_end);
-        }
-
-        if (_formatter)
-        {
-            new_logger->set_formatter(_formatter);
-        }
+        return make_logger(logger_name, sinks_begin, sinks_end);
+    }
 
-        if (_err_handler)
+    // return the registered logger, or create one with the sinks inherited from its ancestors
+    std::shared_ptr<logger> get_or_create(const std::string &logger_name)
+    {
+        std::lock_guard<Mutex> lock(_mutex);
+        auto found = _loggers.find(logger_name);
+        if (found != _loggers.end())
         {
-            new_logger->set_error_handler(_err_handler);
+            return found->second;
         }
-
-        new_logger->set_level(_level);
-        new_logger->flush_on(_flush_level);
-
-        // Add to registry
-        _loggers[logger_name] = new_logger;
-        return new_logger;
+        auto sinks = _tree.inherited_sinks(logger_name);
+        return make_logger(logger_name, sinks.begin(), sinks.end());
     }
 
     template<class It>
@@ -105,7 +200,7 @@ public:
         new_logger->flush_on(_flush_level);
 
         // Add to registry
-        _loggers[logger_name] = new_logger;
+        add(logger_name, new_logger, true);
         return new_logger;
     }
 
@@ -121,13 +216,24 @@ public:
     void drop(const std::string &logger_name)
     {
         std::lock_guard<Mutex> lock(_mutex);
-        _loggers.erase(logger_name);
+        if (_loggers.erase(logger_name) != 0)
+        {
+            publish(*entry(logger_name), nullptr);
+            _tree.detach(logger_name);
+            remove_unused_entries();
+        }
     }
 
     void drop_all()
     {
         std::lock_guard<Mutex> lock(_mutex);
+        for (auto &l : _loggers)
+        {
+            publish(*entry(l.first), nullptr);
+        }
         _loggers.clear();
+        _tree.detach_all();
+        remove_unused_entries();
     }
 
     std::shared_ptr<logger> create(const std::string &logger_name, sinks_init_list sinks)
@@ -178,21 +284,56 @@ public:
     void set_level(level::level_enum log_level)
     {
         std::lock_guard<Mutex> lock(_mutex);
-        for (auto &l : _loggers)
-        {
-            l.second->set_level(log_level);
-        }
+        _tree.set_level_all(log_level);
         _level = log_level;
     }
 
     void flush_on(level::level_enum log_level)
     {
         std::lock_guard<Mutex> lock(_mutex);
-        for (auto &l : _loggers)
+        _tree.flush_on_all(log_level);
+        _flush_level = log_level;
+    }
+
+    // set the level of the named logger and the loggers below it which do not set their own
+    void set_level(const std::string &logger_name, level::level_enum log_level)
+    {
+        std::lock_guard<Mutex> lock(_mutex);
+        _tree.set_level(logger_name, log_level);
+    }
+
+    void flush_on(const std::string &logger_name, level::level_enum log_level)
+    {
+        std::lock_guard<Mutex> lock(_mutex);
+        _tree.flush_on(logger_name, log_level);
+    }
+
+    // set all the levels of the config at once. the global level, if any, is set first.
+    void set_levels(const level_config &config)
+    {
+        std::lock_guard<Mutex> lock(_mutex);
+        for (auto &entry : config)
         {
-            l.second->flush_on(log_level);
+            if (entry.first.empty())
+            {
+                _tree.set_level_all(entry.second);
+                _level = entry.second;
+            }
         }
-        _flush_level = log_level;
+        for (auto &entry : config)
+        {
+            if (!entry.first.empty())
+            {
+                _tree.set_level(entry.first, entry.second);
+            }
+        }
+    }
+
+    // set the sinks of the loggers get_or_create() will create at or below the given name
+    void set_sinks(const std::string &logger_name, std::vector<sink_ptr> sinks)
+    {
+        std::lock_guard<Mutex> lock(_mutex);
+        _tree.set_sinks(logger_name, std::move(sinks));
     }
 
     void set_error_handler(log_err_handler handler)
@@ -229,8 +370,123 @@ public:
     }
 
 private:
+    using entry_map = std::unordered_map<std::string, std::shared_ptr<registry_entry>>;
+
     registry_t<Mutex>() = default;
 
+    // create and register a logger with the registry's settings. must be called with the mutex held.
+    template<class It>
+    std::shared_ptr<logger> make_logger(const std::string &logger_name, const It &sinks_begin, const It &sinks_end)
+    {
+        std::shared_ptr<logger> new_logger;
+        if (_async_mode)
+        {
+            new_logger = std::make_shared<async_logger>(logger_name, sinks_begin, sinks_end, _async_q_size, _overflow_policy,
+                _worker_warmup_cb, _flush_interval_ms, _worker_teardown_cb);
+        }
+        else
+        {
+            new_logger = std::make_shared<logger>(logger_name, sinks_begin, sinks_end);
+        }
+
+        if (_formatter)
+        {
+            new_logger->set_formatter(_formatter);
+        }
+
+        if (_err_handler)
+        {
+            new_logger->set_error_handler(_err_handler);
+        }
+
+        new_logger->set_level(_level);
+        new_logger->flush_on(_flush_level);
+
+        // Add to registry
+        add(logger_name, new_logger, true);
+        return new_logger;
+    }
+
+    // inherit_levels: apply the levels configured for the logger's name or above it
+    void add(const std::string &logger_name, std::shared_ptr<logger> new_logger, bool inherit_levels)
+    {
+        publish(*entry(logger_name), new_logger);
+        _tree.attach(logger_name, new_logger.get(), inherit_levels);
+        _loggers[logger_name] = std::move(new_logger);
+    }
+
+    // return the entry of the given name, creating it if needed. must be called with the mutex held.
+    std::shared_ptr<registry_entry> entry(const std::string &logger_name)
+    {
+        auto entries = _entry_map.load(std::memory_order_relaxed);
+        auto found = entries->find(logger_name);
+        if (found != entries->end())
+        {
+            return found->second;
+        }
+
+        auto new_entry = std::make_shared<registry_entry>(_rcu);
+        auto new_entries = copy_used_entries(*entries);
+        (*new_entries)[logger_name] = new_entry;
+        replace_entry_map(new_entries);
+        return new_entry;
+    }
+
+    // an entry is unused when it holds no logger and no handle refers to it. handles are only created under the
+    // mutex, so the count cannot grow meanwhile. must be called with the mutex held.
+    static bool unused(const std::shared_ptr<registry_entry> &entry)
+    {
+        return entry->logger.load(std::memory_order_relaxed) == nullptr && entry.use_count() == 1;
+    }
+
+    static entry_map *copy_used_entries(const entry_map &entries)
+    {
+        auto copy = new entry_map();
+        for (auto &e : entries)
+        {
+            if (!unused(e.second))
+            {
+                copy->emplace(e.first, e.second);
+            }
+        }
+        return copy;
+    }
+
+    // free the entries of the dropped names no handle refers to. must be called with the mutex held.
+    void remove_unused_entries()
+    {
+        auto entries = _entry_map.load(std::memory_order_relaxed);
+        for (auto &e : *entries)
+        {
+            if (unused(e.second))
+            {
+                replace_entry_map(copy_used_entries(*entries));
+                return;
+            }
+        }
+    }
+
+    // publish the new map, and free the old one (with the entries only it refers to) after the lookups using it
+    void replace_entry_map(entry_map *new_entries)
+    {
+        auto old_entries = _entry_map.load(std::memory_order_relaxed);
+        _entry_map.store(new_entries, std::memory_order_release);
+        _rcu.synchronize();
+        delete old_entries;
+    }
+
+    // set the logger of the entry. must be called with the mutex held.
+    void publish(registry_entry &entry, std::shared_ptr<logger> new_logger)
+    {
+        auto new_ptr = new_logger ? new std::shared_ptr<logger>(std::move(new_logger)) : nullptr;
+        auto old_ptr = entry.logger.exchange(new_ptr, std::memory_order_acq_rel);
+        if (old_ptr != nullptr)
+        {
+            _rcu.synchronize();
+            delete old_ptr;
+        }
+    }
+
     void throw_if_exists(const std::string &logger_name)
     {
         if (_loggers.find(logger_name) != _loggers.end())
@@ -241,6 +497,9 @@ private:
 
     Mutex _mutex;
     std::unordered_map<std::string, std::shared_ptr<logger>> _loggers;
+    logger_tree _tree;
+    rcu_domain _rcu;
+    std::atomic<entry_map *> _entry_map{new entry_map()};
     formatter_ptr _formatter;
     level::level_enum _level = level::info;
     level::level_enum _flush_level = level::off;
@@ -0,0 +1,406 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+#pragma once
+
+// Ring buffer of log records in POSIX shared memory, written by a logging process and drained by another one
+// (see sinks/shm_ring_sink.h and the spdlog-shm-reader example).
+//
+// One writer and one reader. Neither ever waits for the other and no lock is shared between the processes, so a
+// stalled or crashed reader cannot block the writer. When the ring is full the writer either drops the new record
+// or overwrites the oldest ones. Records dropped or overwritten before being read are counted in dropped().
+// The positions live in the shared memory: a restarted reader continues where the previous one stopped, and a
+// restarted writer appends to the existing ring.
+//
+// Layout: a header, then the records, each a 16 byte record header followed by the payload, padded to 16 bytes
+// (so the space left before the end of the ring always fits a record header).
+// Records are numbered: the reader counts the records overwritten before being read from the gaps in the numbers.
+// A record which would not fit before the end of the ring is preceded by a padding record up to the end.
+// Positions only grow; the offset in the ring is the position modulo the capacity (a power of two).
+// Overwriting: the writer first moves the tail (the oldest record kept) past the records it overwrites.
+// The reader copies a record, then checks the tail did not move past it meanwhile, in which case it drops the copy.
+// When dropping new records, the writer moves the tail up to the read position instead, so a writer restarted with
+// the other policy finds the tail on an intact record.
+//
+// The processes race on the records: the ring is only accessed through std::atomic<uint64_t> words, with relaxed
+// loads and stores ordered by fences, and the reader discards the records the tail moved past. This assumes the
+// 64 bit atomics are lock-free (so address-free, as required to share them between processes), and that both
+// processes are built for the same architecture. A second writer or reader on the same ring corrupts it.
+//
+// On glibc older than 2.34, link with -lrt for shm_open().
+
+#ifndef _WIN32
+
+#include "../common.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace spdlog {
+namespace details {
+
+class shm_ring
+{
+public:
+    enum record_type : uint32_t
+    {
+        text = 1,   // formatted text
+        binary = 2, // binary_formatter output (see sinks/shm_ring_sink.h)
+        padding = 3 // skip to the end of the ring
+    };
+
+    // create the shared memory ring, or attach to an existing one with the same capacity (rounded up to a power
+    // of two). throw spdlog_ex on failure.
+    shm_ring(const std::string &name, size_t capacity)
+        : _name(name)
+    {
+        size_t rounded = 64;
+        while (rounded < capacity)
+        {
+            rounded *= 2;
+        }
+        _fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT, 0600);
+        if (_fd == -1)
+        {
+            throw spdlog_ex("Failed opening shared memory " + name, errno);
+        }
+        struct stat st;
+        if (::fstat(_fd, &st) != 0)
+        {
+            _fail("Failed opening shared memory " + name);
+        }
+        auto size = sizeof(header) + rounded;
+        if (st.st_size == 0 && ::ftruncate(_fd, static_cast<off_t>(size)) != 0)
+        {
+            _fail("Failed sizing shared memory " + name);
+        }
+        _map(size);
+        if (_header->magic.load(std::memory_order_acquire) != magic_value)
+        {
+            new (_header) header();
+            _header->capacity = rounded;
+            _header->magic.store(magic_value, std::memory_order_release);
+        }
+        else if (_header->capacity != rounded)
+        {
+            _fail("Shared memory " + name + " holds a ring of a different capacity", false);
+        }
+    }
+
+    // attach to an existing ring. throw spdlog_ex if there is none.
+    explicit shm_ring(const std::string &name)
+        : _name(name)
+    {
+        _fd = ::shm_open(name.c_str(), O_RDWR, 0600);
+        if (_fd == -1)
+        {
+            throw spdlog_ex("Failed opening shared memory " + name, errno);
+        }
+        struct stat st;
+        if (::fstat(_fd, &st) != 0)
+        {
+            _fail("Failed opening shared memory " + name);
+        }
+        if (static_cast<size_t>(st.st_size) < sizeof(header))
+        {
+            _fail("Shared memory " + name + " holds no ring", false);
+        }
+        _map(static_cast<size_t>(st.st_size));
+        if (_header->magic.load(std::memory_order_acquire) != magic_value ||
+            sizeof(header) + _header->capacity != static_cast<size_t>(st.st_size))
+        {
+            _fail("Shared memory " + name + " holds no ring", false);
+        }
+    }
+
+    ~shm_ring()
+    {
+        if (_header != nullptr)
+        {
+            ::munmap(_header, _size);
+        }
+        if (_fd != -1)
+        {
+            ::close(_fd);
+        }
+    }
+
+    shm_ring(const shm_ring &) = delete;
+    shm_ring &operator=(const shm_ring &) = delete;
+
+    // remove the shared memory name (processes attached keep their mapping)
+    static void remove(const std::string &name)
+    {
+        ::shm_unlink(name.c_str());
+    }
+
+    size_t capacity() const
+    {
+        return _header->capacity;
+    }
+
+    // records dropped, or overwritten before being read (counted once the reader got past them)
+    uint64_t dropped() const
+    {
+        return _header->dropped.load(std::memory_order_relaxed) + _header->overwritten.load(std::memory_order_relaxed);
+    }
+
+    // writer: position of the next record. positions only grow, across writer restarts too.
+    uint64_t write_position() const
+    {
+        return _header->write_pos.load(std::memory_order_relaxed);
+    }
+
+    // writer: append a record. if the ring is full, drop it or overwrite the oldest records.
+    // return false if the record was dropped.
+    bool write(record_type type, const char *data, size_t size, bool overwrite)
+    {
+        auto cap = _header->capacity;
+        auto len = _record_size(size);
+        if (len > cap / 2)
+        {
+            _header->dropped.fetch_add(1, std::memory_order_relaxed);
+            return false; // too large for the ring
+        }
+        auto w = _header->write_pos.load(std::memory_order_relaxed);
+        auto offset = w & (cap - 1);
+        uint64_t pad = offset + len > cap ? cap - offset : 0;
+        auto end = w + pad + len;
+
+        if (overwrite)
+        {
+            if (end > cap)
+            {
+                _free_until(end - cap);
+            }
+        }
+        else
+        {
+            auto r = _header->read_pos.load(std::memory_order_acquire);
+            if (end - r > cap)
+            {
+                _header->dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            // the records before the read position may be overwritten: keep the tail on an intact one
+            if (_header->tail.load(std::memory_order_relaxed) < r)
+            {
+                _header->tail.store(r, std::memory_order_relaxed);
+            }
+        }
+
+        if (pad != 0)
+        {
+            _write_header(offset, padding, 0, 0);
+            offset = 0;
+        }
+        auto seq = _header->next_seq.load(std::memory_order_relaxed);
+        _header->next_seq.store(seq + 1, std::memory_order_relaxed);
+        _write_header(offset, type, static_cast<uint32_t>(size), seq);
+        _store(offset + sizeof(record_header), data, size);
+        _header->write_pos.store(end, std::memory_order_release);
+        return true;
+    }
+
+    // reader: pass each record written since the last read to fun(record_type, const char *data, size_t size).
+    // return the number of records read.
+    template<class Fun>
+    size_t read(Fun fun)
+    {
+        auto cap = _header->capacity;
+        auto r = _header->read_pos.load(std::memory_order_relaxed);
+        auto w = _header->write_pos.load(std::memory_order_acquire);
+        auto seq = _header->read_seq.load(std::memory_order_relaxed);
+        size_t count = 0;
+        while (r < w)
+        {
+            auto tail = _header->tail.load(std::memory_order_acquire);
+            if (r < tail)
+            {
+                r = tail; // overwritten before being read
+                continue;
+            }
+            auto offset = r & (cap - 1);
+            record_header rh;
+            _load(offset, &rh, sizeof(rh));
+            uint64_t len = rh.type == padding ? cap - offset : _record_size(rh.size);
+            if (rh.type != padding && offset + len <= cap)
+            {
+                _copy.resize(rh.size);
+                _load(offset + sizeof(record_header), &_copy[0], rh.size);
+            }
+            // the copy is valid only if the writer did not start overwriting the record meanwhile
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (_header->tail.load(std::memory_order_relaxed) > r)
+            {
+                continue;
+            }
+            if (offset + len > cap || r + len > w)
+            {
+                // corrupted: skip what was written
+                r = w;
+                break;
+            }
+            r += len;
+            if (rh.type != padding)
+            {
+                if (rh.seq > seq)
+                {
+                    _header->overwritten.fetch_add(rh.seq - seq, std::memory_order_relaxed);
+                }
+                seq = rh.seq + 1;
+                _header->read_seq.store(seq, std::memory_order_relaxed);
+                fun(static_cast<record_type>(rh.type), _copy.data(), _copy.size());
+                ++count;
+            }
+        }
+        _header->read_pos.store(r, std::memory_order_release);
+        return count;
+    }
+
+private:
+    static const uint64_t magic_value = 0x53504c4f47524e47ULL; // "SPLOGRNG"
+
+    struct header
+    {
+        std::atomic<uint64_t> magic{0};
+        uint64_t capacity{0};
+        // written by the writer
+        alignas(64) std::atomic<uint64_t> write_pos{0};
+        std::atomic<uint64_t> tail{0};
+        std::atomic<uint64_t> next_seq{0};
+        std::atomic<uint64_t> dropped{0};
+        // written by the reader
+        alignas(64) std::atomic<uint64_t> read_pos{0};
+        std::atomic<uint64_t> read_seq{0};
+        std::atomic<uint64_t> overwritten{0};
+        char pad[40];
+    };
+
+    struct record_header
+    {
+        uint32_t size;
+        uint32_t type;
+        uint64_t seq;
+    };
+
+    static uint64_t _record_size(size_t payload)
+    {
+        return (sizeof(record_header) + payload + 15) & ~uint64_t(15);
+    }
+
+    std::atomic<uint64_t> *_words()
+    {
+        static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "the ring is an array of 64 bit atomics");
+        return reinterpret_cast<std::atomic<uint64_t> *>(_header + 1);
+    }
+
+    // copy size bytes to the ring at offset (a multiple of 8), in whole words: the last one is zero padded
+    void _store(uint64_t offset, const void *data, size_t size)
+    {
+        auto word = _words() + offset / sizeof(uint64_t);
+        auto bytes = static_cast<const char *>(data);
+        for (; size != 0; ++word)
+        {
+            auto n = std::min(size, sizeof(uint64_t));
+            uint64_t value = 0;
+            std::memcpy(&value, bytes, n);
+            word->store(value, std::memory_order_relaxed);
+            bytes += n;
+            size -= n;
+        }
+    }
+
+    // copy size bytes of the ring at offset (a multiple of 8)
+    void _load(uint64_t offset, void *data, size_t size)
+    {
+        auto word = _words() + offset / sizeof(uint64_t);
+        auto bytes = static_cast<char *>(data);
+        for (; size != 0; ++word)
+        {
+            auto n = std::min(size, sizeof(uint64_t));
+            auto value = word->load(std::memory_order_relaxed);
+            std::memcpy(bytes, &value, n);
+            bytes += n;
+            size -= n;
+        }
+    }
+
+    void _write_header(uint64_t offset, record_type type, uint32_t size, uint64_t seq)
+    {
+        record_header rh{size, type, seq};
+        _store(offset, &rh, sizeof(rh));
+    }
+
+    // writer: move the tail past the records before the given position
+    void _free_until(uint64_t pos)
+    {
+        auto cap = _header->capacity;
+        auto tail = _header->tail.load(std::memory_order_relaxed);
+        if (tail >= pos)
+        {
+            return;
+        }
+        while (tail < pos)
+        {
+            auto offset = tail & (cap - 1);
+            record_header rh;
+            _load(offset, &rh, sizeof(rh));
+            tail += rh.type == padding ? cap - offset : _record_size(rh.size);
+        }
+        _header->tail.store(tail, std::memory_order_relaxed);
+        // the reader must see the new tail before any overwritten data
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    void _map(size_t size)
+    {
+        auto p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+        if (p == MAP_FAILED)
+        {
+            _fail("Failed mapping shared memory " + _name);
+        }
+        _header = static_cast<header *>(p);
+        _size = size;
+    }
+
+    void _fail(const std::string &msg, bool with_errno = true)
+    {
+        auto err = errno;
+        ::close(_fd);
+        _fd = -1;
+        if (_header != nullptr)
+        {
+            ::munmap(_header, _size);
+            _header = nullptr;
+        }
+        if (with_errno)
+        {
+            throw spdlog_ex(msg, err);
+        }
+        throw spdlog_ex(msg);
+    }
+
+    const std::string _name;
+    int _fd{-1};
+    header *_header{nullptr};
+    size_t _size{0};
+    std::string _copy; // reader: the record being read
+};
+
+} // namespace details
+} // namespace spdlog
+
+#endif // _WIN32
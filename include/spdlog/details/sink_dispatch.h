@@ -0,0 +1,140 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+#pragma once
+
+// Per level lists of the sinks accepting the level, so passing a message to the sinks only touches the interested
+// ones instead of loading each sink's level.
+//
+// The lists are bitmasks of indexes into the owner's sink vector, which must not change during the table's lifetime.
+// They are rebuilt on the next dispatch after any sink's level changed (see sinks::sink::levels_version()).
+// Rebuilds are serialized by a mutex and read the version before the levels, so a table is never marked up to date
+// with older levels: a level changing during a rebuild leads to another one. A message logged while a level changes
+// may see the sink with its old or its new level, as when checking the sink's level directly.
+// With more than max_sinks sinks, each sink's level is checked instead.
+
+#include "../common.h"
+#include "../sinks/sink.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace spdlog {
+namespace details {
+
+class sink_dispatch_table
+{
+public:
+    static const size_t max_sinks = 64;
+
+    // the vector must outlive the table and keep its sinks
+    explicit sink_dispatch_table(const std::vector<sink_ptr> &sinks)
+        : _sinks(sinks)
+    {
+    }
+
+    sink_dispatch_table(const sink_dispatch_table &) = delete;
+    sink_dispatch_table &operator=(const sink_dispatch_table &) = delete;
+
+    // call fun(sink) for each sink accepting the given level, in order
+    template<class Fun>
+    void for_each(level::level_enum lvl, Fun fun)
+    {
+        if (_sinks.size() > max_sinks)
+        {
+            for (auto &sink : _sinks)
+            {
+                if (sink->should_log(lvl))
+                {
+                    fun(*sink);
+                }
+            }
+            return;
+        }
+        for (auto mask = mask_of(lvl); mask != 0; mask &= mask - 1)
+        {
+            fun(*_sinks[lowest_bit(mask)]);
+        }
+    }
+
+    // whether the sink at the given index of the vector accepts the level
+    bool accepts(level::level_enum lvl, size_t index)
+    {
+        if (_sinks.size() > max_sinks)
+        {
+            return _sinks[index]->should_log(lvl);
+        }
+        return (mask_of(lvl) >> index) & 1;
+    }
+
+private:
+    uint64_t mask_of(level::level_enum lvl)
+    {
+        if (_version.load(std::memory_order_acquire) != sinks::sink::levels_version().load(std::memory_order_acquire))
+        {
+            rebuild();
+        }
+        return _masks[lvl].load(std::memory_order_relaxed);
+    }
+
+    // index of the lowest bit set. mask must not be 0.
+    static size_t lowest_bit(uint64_t mask)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_t>(__builtin_ctzll(mask));
+#elif defined(_MSC_VER) && defined(_M_X64)
+        unsigned long index;
+        _BitScanForward64(&index, mask);
+        return index;
+#else
+        size_t index = 0;
+        while ((mask & 1) == 0)
+        {
+            mask >>= 1;
+            ++index;
+        }
+        return index;
+#endif
+    }
+
+    void rebuild()
+    {
+        std::lock_guard<std::mutex> lock(_rebuild_mutex);
+        // read the version first: the levels read below are at least as recent
+        auto version = sinks::sink::levels_version().load(std::memory_order_acquire);
+        if (_version.load(std::memory_order_relaxed) == version)
+        {
+            return; // rebuilt by another thread meanwhile
+        }
+        uint64_t masks[level::off + 1] = {};
+        for (size_t i = 0; i < _sinks.size(); ++i)
+        {
+            for (int lvl = _sinks[i]->level(); lvl <= level::off; ++lvl)
+            {
+                masks[lvl] |= uint64_t(1) << i;
+            }
+        }
+        for (int lvl = level::trace; lvl <= level::off; ++lvl)
+        {
+            _masks[lvl].store(masks[lvl], std::memory_order_relaxed);
+        }
+        _version.store(version, std::memory_order_release);
+    }
+
+    const std::vector<sink_ptr> &_sinks;
+    std::atomic<uint64_t> _masks[level::off + 1]{};
+    // levels version the masks were built from. 0: never built (the global version starts at 1)
+    std::atomic<uint64_t> _version{0};
+    std::mutex _rebuild_mutex;
+};
+
+} // namespace details
+} // namespace spdlog
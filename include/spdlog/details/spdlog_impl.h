@@ -8,7 +8,9 @@
 //
 // Global registry functions
 //
+#include "../details/level_file_watcher.h"
 #include "../details/registry.h"
+#include "../sinks/binary_file_sink.h"
 #include "../sinks/file_sinks.h"
 #include "../sinks/stdout_sinks.h"
 #include "../spdlog.h"
@@ -27,9 +29,11 @@
 #endif
 
 #include <chrono>
+#include <cstdlib>
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 inline void spdlog::register_logger(std::shared_ptr<logger> logger)
 {
@@ -41,6 +45,11 @@ inline std::shared_ptr<spdlog::logger> spdlog::get(const std::string &name)
     return details::registry::instance().get(name);
 }
 
+inline spdlog::logger_handle spdlog::get_handle(const std::string &name)
+{
+    return details::registry::instance().get_handle(name);
+}
+
 inline void spdlog::drop(const std::string &name)
 {
     details::registry::instance().drop(name);
@@ -57,6 +66,22 @@ inline std::shared_ptr<spdlog::logger> spdlog::basic_logger_st(const std::string
     return create<spdlog::sinks::simple_file_sink_st>(logger_name, filename, truncate);
 }
 
+// Create multi/single threaded binary file logger.
+// The text formatter is set to an empty pattern since its output is not used by the binary sink.
+inline std::shared_ptr<spdlog::logger> spdlog::binary_logger_mt(const std::string &logger_name, const filename_t &filename, bool truncate)
+{
+    auto logger = create<spdlog::sinks::binary_file_sink_mt>(logger_name, filename, truncate);
+    logger->set_formatter(std::make_shared<pattern_formatter>("", pattern_time_type::local, ""));
+    return logger;
+}
+
+inline std::shared_ptr<spdlog::logger> spdlog::binary_logger_st(const std::string &logger_name, const filename_t &filename, bool truncate)
+{
+    auto logger = create<spdlog::sinks::binary_file_sink_st>(logger_name, filename, truncate);
+    logger->set_formatter(std::make_shared<pattern_formatter>("", pattern_time_type::local, ""));
+    return logger;
+}
+
 // Create multi/single threaded rotating file logger
 inline std::shared_ptr<spdlog::logger> spdlog::rotating_logger_mt(
     const std::string &logger_name, const filename_t &filename, size_t max_file_size, size_t max_files)
@@ -250,6 +275,53 @@ inline void spdlog::flush_on(level::level_enum log_level)
     return details::registry::instance().flush_on(log_level);
 }
 
+inline void spdlog::set_level(const std::string &logger_name, level::level_enum log_level)
+{
+    details::registry::instance().set_level(logger_name, log_level);
+}
+
+inline void spdlog::flush_on(const std::string &logger_name, level::level_enum log_level)
+{
+    details::registry::instance().flush_on(logger_name, log_level);
+}
+
+inline void spdlog::set_levels(const std::string &spec)
+{
+    details::registry::instance().set_levels(details::parse_level_config(spec));
+}
+
+inline void spdlog::load_env_levels(const char *env_var)
+{
+    const char *spec = std::getenv(env_var);
+    if (spec != nullptr)
+    {
+        set_levels(spec);
+    }
+}
+
+inline void spdlog::watch_level_file(const filename_t &filename)
+{
+    // the registry must outlive the watcher's thread
+    auto &registry = details::registry::instance();
+    details::level_file_watcher::instance().watch(
+        filename, [&registry](const std::string &content) { registry.set_levels(details::parse_level_config(content)); });
+}
+
+inline void spdlog::stop_watching_level_file()
+{
+    details::level_file_watcher::instance().stop();
+}
+
+inline void spdlog::set_sinks(const std::string &logger_name, std::vector<sink_ptr> sinks)
+{
+    details::registry::instance().set_sinks(logger_name, std::move(sinks));
+}
+
+inline std::shared_ptr<spdlog::logger> spdlog::get_or_create(const std::string &logger_name)
+{
+    return details::registry::instance().get_or_create(logger_name);
+}
+
 inline void spdlog::set_error_handler(log_err_handler handler)
 {
     return details::registry::instance().set_error_handler(std::move(handler));
@@ -276,3 +348,23 @@ inline void spdlog::drop_all()
 {
     details::registry::instance().drop_all();
 }
+
+inline void spdlog::set_log_sites_by_file(const std::string &file_glob, log_site_state state)
+{
+    details::log_site_registry::instance().set_by_file(file_glob, state);
+}
+
+inline void spdlog::set_log_sites_by_function(const std::string &function_glob, log_site_state state)
+{
+    details::log_site_registry::instance().set_by_function(function_glob, state);
+}
+
+inline void spdlog::set_log_sites_by_logger(const std::string &logger_glob, log_site_state state)
+{
+    details::log_site_registry::instance().set_by_logger(logger_glob, state);
+}
+
+inline void spdlog::reset_log_sites()
+{
+    details::log_site_registry::instance().reset();
+}
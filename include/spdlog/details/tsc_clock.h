@@ -0,0 +1,175 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+#pragma once
+
+// Fast clock source based on the cpu timestamp counter (rdtsc).
+// Reading the counter costs a few cycles. The ticks are converted to wall clock time
+// using a calibration (ticks <-> system clock) which is refreshed periodically by a background thread.
+// Used by loggers instead of os::now() if SPDLOG_CLOCK_TSC is defined (see tweakme.h).
+//
+// The first calibration takes 10ms, measured by the background thread: the first log calls do not wait for it.
+// Until it is done, ticks are converted to the current system clock time. Call tsc_clock::init() at startup to wait
+// for it instead, e.g. before starting an async logger's worker.
+// The clock is never destroyed, so messages logged during static destruction still get their time.
+//
+// On non x86 platforms the steady clock is used as the tick source.
+
+#include "../common.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define SPDLOG_HAS_RDTSC
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define SPDLOG_HAS_RDTSC
+#endif
+
+namespace spdlog {
+namespace details {
+
+class tsc_clock
+{
+public:
+    // how often the background thread recalibrates, and how long the first calibration takes.
+    // enumerators rather than static members: durations take their count by reference, which would need a definition.
+    enum : std::chrono::milliseconds::rep
+    {
+        calibration_interval_ms = 1000,
+        first_calibration_ms = 10
+    };
+
+    tsc_clock(const tsc_clock &) = delete;
+    tsc_clock &operator=(const tsc_clock &) = delete;
+
+    static tsc_clock &instance()
+    {
+        // never destroyed: loggers may still log from the destructors of other static objects
+        static tsc_clock *s_instance = new tsc_clock();
+        return *s_instance;
+    }
+
+    // create the clock and wait for the first calibration
+    static void init()
+    {
+        auto &clock = instance();
+        std::unique_lock<std::mutex> lock(clock._mutex);
+        clock._cv.wait(lock, [&clock] { return clock._seq.load(std::memory_order_relaxed) != 0; });
+    }
+
+    // read the raw counter
+    static uint64_t ticks()
+    {
+#ifdef SPDLOG_HAS_RDTSC
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    // convert ticks to wall clock time using the latest calibration
+    log_clock::time_point to_time_point(uint64_t tick_count) const
+    {
+        int64_t base_ticks, base_ns;
+        double ns_per_tick;
+        unsigned seq;
+        do
+        {
+            seq = _seq.load(std::memory_order_acquire);
+            base_ticks = _base_ticks.load(std::memory_order_relaxed);
+            base_ns = _base_ns.load(std::memory_order_relaxed);
+            ns_per_tick = _ns_per_tick.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while ((seq & 1) != 0 || seq != _seq.load(std::memory_order_relaxed));
+
+        if (seq == 0)
+        {
+            // not calibrated yet
+            return log_clock::now();
+        }
+
+        auto delta_ticks = static_cast<int64_t>(tick_count - static_cast<uint64_t>(base_ticks));
+        auto ns = base_ns + static_cast<int64_t>(static_cast<double>(delta_ticks) * ns_per_tick);
+        return log_clock::time_point(std::chrono::duration_cast<log_clock::duration>(std::chrono::nanoseconds(ns)));
+    }
+
+private:
+    struct sample
+    {
+        int64_t ticks;
+        int64_t ns;
+    };
+
+    tsc_clock()
+        : _last(take_sample())
+    {
+        std::thread(&tsc_clock::calibration_loop, this).detach();
+    }
+
+    static sample take_sample()
+    {
+        // bracket the system clock read by two counter reads to reduce the error
+        auto t1 = ticks();
+        auto now = log_clock::now();
+        auto t2 = ticks();
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+        return sample{static_cast<int64_t>(t1 + (t2 - t1) / 2), static_cast<int64_t>(ns)};
+    }
+
+    static double ns_per_tick(const sample &from, const sample &to)
+    {
+        auto delta_ticks = to.ticks - from.ticks;
+        return delta_ticks > 0 ? static_cast<double>(to.ns - from.ns) / static_cast<double>(delta_ticks) : 1.0;
+    }
+
+    void publish(const sample &base, double rate)
+    {
+        auto seq = _seq.load(std::memory_order_relaxed);
+        _seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        _base_ticks.store(base.ticks, std::memory_order_relaxed);
+        _base_ns.store(base.ns, std::memory_order_relaxed);
+        _ns_per_tick.store(rate, std::memory_order_relaxed);
+        _seq.store(seq + 2, std::memory_order_release);
+    }
+
+    void calibration_loop()
+    {
+        // initial calibration over a short window, refined every calibration_interval_ms afterwards
+        std::this_thread::sleep_for(std::chrono::milliseconds(first_calibration_ms));
+        for (;;)
+        {
+            auto now = take_sample();
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                publish(now, ns_per_tick(_last, now));
+            }
+            _cv.notify_all();
+            _last = now;
+            std::this_thread::sleep_for(std::chrono::milliseconds(calibration_interval_ms));
+        }
+    }
+
+    std::atomic<unsigned> _seq{0};
+    std::atomic<int64_t> _base_ticks{0};
+    std::atomic<int64_t> _base_ns{0};
+    std::atomic<double> _ns_per_tick{1.0};
+
+    // used by the background thread only
+    sample _last;
+    // init() waits for the first calibration
+    std::mutex _mutex;
+    std::condition_variable _cv;
+};
+
+} // namespace details
+} // namespace spdlog
@@ -21,6 +21,12 @@ class formatter
 public:
     virtual ~formatter() = default;
     virtual void format(details::log_msg &msg) = 0;
+
+    // log_msg fields (see capture::flags) this formatter reads. loggers skip capturing the others.
+    virtual unsigned capture_flags() const
+    {
+        return capture::all;
+    }
 };
 
 class pattern_formatter SPDLOG_FINAL : public formatter
@@ -31,11 +37,13 @@ public:
     pattern_formatter(const pattern_formatter &) = delete;
     pattern_formatter &operator=(const pattern_formatter &) = delete;
     void format(details::log_msg &msg) override;
+    unsigned capture_flags() const override;
 
 private:
     const std::string _eol;
     const std::string _pattern;
     const pattern_time_type _pattern_time;
+    unsigned _capture_flags{capture::none};
     std::vector<std::unique_ptr<details::flag_formatter>> _formatters;
     std::tm get_time(details::log_msg &msg);
     void handle_flag(char flag);
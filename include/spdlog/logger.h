@@ -13,8 +13,13 @@
 // 3. Pass the formatted message to its sinks to performa the actual logging
 
 #include "common.h"
+#include "details/backtracer.h"
+#include "details/log_limiter.h"
+#include "details/sink_dispatch.h"
 #include "sinks/base_sink.h"
 
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
@@ -41,6 +46,20 @@ public:
     template<typename... Args>
     void log(level::level_enum lvl, const char *msg);
 
+    // log with the source location of the call (see the SPDLOG_<LEVEL> macros in spdlog.h)
+    template<typename... Args>
+    void log(const source_loc &loc, level::level_enum lvl, const char *fmt, const Args &... args);
+
+    template<typename... Args>
+    void log(const source_loc &loc, level::level_enum lvl, const char *msg);
+
+    // log regardless of the logger's level (used by log sites enabled at runtime, see details/log_site.h)
+    template<typename... Args>
+    void force_log(const source_loc &loc, level::level_enum lvl, const char *fmt, const Args &... args);
+
+    template<typename... Args>
+    void force_log(const source_loc &loc, level::level_enum lvl, const char *msg);
+
     template<typename Arg1, typename... Args>
     void trace(const char *fmt, const Arg1 &, const Args &... args);
 
@@ -59,6 +78,52 @@ public:
     template<typename Arg1, typename... Args>
     void critical(const char *fmt, const Arg1 &, const Args &... args);
 
+    // rate limited logging. the state of the call site is kept by the caller, usually in a static:
+    //     static spdlog::log_limiter limiter;
+    //     logger->warn_every_n(limiter, 1000, "queue full {}", n);
+    // suppressed calls are not formatted. the next call let through also logs how many calls were suppressed.
+    // see also the SPDLOG_<LEVEL>_EVERY_N/EVERY/SAMPLED macros in spdlog.h, which declare the limiter for you.
+    template<typename... Args>
+    void log_every_n(log_limiter &limiter, level::level_enum lvl, size_t n, const char *fmt, const Args &... args);
+
+    template<typename Rep, typename Period, typename... Args>
+    void log_every(log_limiter &limiter, level::level_enum lvl, const std::chrono::duration<Rep, Period> &interval, const char *fmt,
+        const Args &... args);
+
+    template<typename... Args>
+    void log_sampled(log_limiter &limiter, level::level_enum lvl, double ratio, const char *fmt, const Args &... args);
+
+    template<typename... Args>
+    void warn_every_n(log_limiter &limiter, size_t n, const char *fmt, const Args &... args);
+
+    template<typename Rep, typename Period, typename... Args>
+    void warn_every(log_limiter &limiter, const std::chrono::duration<Rep, Period> &interval, const char *fmt, const Args &... args);
+
+    template<typename... Args>
+    void warn_sampled(log_limiter &limiter, double ratio, const char *fmt, const Args &... args);
+
+    // keep the last n_messages messages filtered out by the logger's level in a ring, without formatting them,
+    // and log them (oldest first) before the next message at or above trigger_level, or on dump_backtrace().
+    // storing a message in the ring costs a fraction of logging it: no formatting and no sink calls.
+    // not thread safe: enable or disable before logging from other threads.
+    void enable_backtrace(size_t n_messages, level::level_enum trigger_level = level::err);
+    void disable_backtrace();
+
+    // log the messages kept in the backtrace ring since the last dump, oldest first
+    void dump_backtrace();
+
+    bool should_backtrace() const;
+
+    // store a message in the backtrace ring (used by the SPDLOG_<LEVEL> macros for messages below the level)
+    template<typename... Args>
+    void push_backtrace(const source_loc &loc, level::level_enum lvl, const char *fmt, const Args &... args);
+
+    template<typename... Args>
+    void push_backtrace(const source_loc &loc, level::level_enum lvl, const char *msg);
+
+    template<typename T>
+    void push_backtrace(const source_loc &loc, level::level_enum lvl, const T &msg);
+
 #ifdef SPDLOG_WCHAR_TO_UTF8_SUPPORT
     template<typename... Args>
     void log(level::level_enum lvl, const wchar_t *msg);
@@ -66,6 +131,18 @@ public:
     template<typename... Args>
     void log(level::level_enum lvl, const wchar_t *fmt, const Args &... args);
 
+    template<typename... Args>
+    void log(const source_loc &loc, level::level_enum lvl, const wchar_t *msg);
+
+    template<typename... Args>
+    void log(const source_loc &loc, level::level_enum lvl, const wchar_t *fmt, const Args &... args);
+
+    template<typename... Args>
+    void force_log(const source_loc &loc, level::level_enum lvl, const wchar_t *msg);
+
+    template<typename... Args>
+    void force_log(const source_loc &loc, level::level_enum lvl, const wchar_t *fmt, const Args &... args);
+
     template<typename... Args>
     void trace(const wchar_t *fmt, const Args &... args);
 
@@ -88,6 +165,12 @@ public:
     template<typename T>
     void log(level::level_enum lvl, const T &);
 
+    template<typename T>
+    void log(const source_loc &loc, level::level_enum lvl, const T &);
+
+    template<typename T>
+    void force_log(const source_loc &loc, level::level_enum lvl, const T &);
+
     template<typename T>
     void trace(const T &msg);
 
@@ -135,17 +218,28 @@ protected:
     // return true if the given message level should trigger a flush
     bool _should_flush_on(const details::log_msg &msg);
 
+    // dump the backtrace ring if the given message level triggers it
+    void _dump_backtrace_on(level::level_enum lvl);
+
     // increment the message count (only if defined(SPDLOG_ENABLE_MESSAGE_COUNTER))
     void _incr_msg_counter(details::log_msg &msg);
 
+    // pass the formatter to the sinks, and recalc which log_msg fields need to be captured according to the formatter
+    // and the sinks
+    void _formatter_changed();
+
     const std::string _name;
     std::vector<sink_ptr> _sinks;
+    details::sink_dispatch_table _sink_dispatch{_sinks};
     formatter_ptr _formatter;
     spdlog::level_t _level;
     spdlog::level_t _flush_level;
     log_err_handler _err_handler;
     std::atomic<time_t> _last_err_time;
     std::atomic<size_t> _msg_counter;
+    // written by set_pattern() and set_formatter() while other threads log
+    std::atomic<unsigned> _capture_flags{capture::all};
+    std::unique_ptr<details::backtracer> _backtracer;
 };
 } // namespace spdlog
 
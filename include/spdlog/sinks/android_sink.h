@@ -59,6 +59,11 @@ public:
 
     void flush() override {}
 
+    unsigned capture_flags() const override
+    {
+        return _use_raw_msg ? capture::raw : capture::none;
+    }
+
 private:
     static android_LogPriority convert_to_android(spdlog::level::level_enum level)
     {
@@ -8,6 +8,7 @@
 #include "../common.h"
 #include "../details/os.h"
 #include "base_sink.h"
+#include "flush_policy.h"
 
 #include <string>
 #include <unordered_map>
@@ -19,13 +20,15 @@ namespace sinks {
  * This sink prefixes the output with an ANSI escape sequence color code depending on the severity
  * of the message.
  * If no color terminal detected, omit the escape codes.
+ * Each message is written with a single fwrite. The stream is flushed according to the flush_policy.
  */
 template<class Mutex>
 class ansicolor_sink : public base_sink<Mutex>
 {
 public:
-    explicit ansicolor_sink(FILE *file)
+    explicit ansicolor_sink(FILE *file, const flush_policy &policy = flush_policy::every_message())
         : target_file_(file)
+        , flush_tracker_(policy)
     {
         should_do_colors_ = details::os::in_terminal(file) && details::os::is_color_terminal();
         colors_[level::trace] = white;
@@ -48,6 +51,19 @@ public:
         colors_[color_level] = color;
     }
 
+    void set_flush_policy(const flush_policy &policy)
+    {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::_mutex);
+        flush_tracker_.set_policy(policy);
+    }
+
+    // write the color codes or not, whether the stream is a color terminal or not
+    void set_colors_enabled(bool enabled)
+    {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::_mutex);
+        should_do_colors_ = enabled;
+    }
+
     /// Formatting codes
     const std::string reset = "\033[m";
     const std::string bold = "\033[1m";
@@ -78,6 +94,11 @@ public:
     const std::string on_cyan = "\033[46m";
     const std::string on_white = "\033[47m";
 
+    unsigned capture_flags() const override
+    {
+        return capture::none;
+    }
+
 protected:
     void _sink_it(const details::log_msg &msg) override
     {
@@ -85,37 +106,42 @@ protected:
         // If color is not supported in the terminal, log as is instead.
         if (should_do_colors_ && msg.color_range_end > msg.color_range_start)
         {
+            // assemble the colored line, to write it at once
+            line_buffer_.clear();
             // before color range
-            _print_range(msg, 0, msg.color_range_start);
+            _append_range(msg, 0, msg.color_range_start);
             // in color range
-            _print_ccode(colors_[msg.level]);
-            _print_range(msg, msg.color_range_start, msg.color_range_end);
-            _print_ccode(reset);
+            line_buffer_ << colors_[msg.level];
+            _append_range(msg, msg.color_range_start, msg.color_range_end);
+            line_buffer_ << reset;
             // after color range
-            _print_range(msg, msg.color_range_end, msg.formatted.size());
+            _append_range(msg, msg.color_range_end, msg.formatted.size());
+            fwrite(line_buffer_.data(), sizeof(char), line_buffer_.size(), target_file_);
         }
         else
         {
-            _print_range(msg, 0, msg.formatted.size());
+            fwrite(msg.formatted.data(), sizeof(char), msg.formatted.size(), target_file_);
+        }
+        if (flush_tracker_.should_flush(msg.level, msg.formatted.size()))
+        {
+            _flush();
         }
-        _flush();
     }
 
     void _flush() override
     {
         fflush(target_file_);
+        flush_tracker_.flushed();
     }
 
 private:
-    void _print_ccode(const std::string &color_code)
-    {
-        fwrite(color_code.data(), sizeof(char), color_code.size(), target_file_);
-    }
-    void _print_range(const details::log_msg &msg, size_t start, size_t end)
+    void _append_range(const details::log_msg &msg, size_t start, size_t end)
     {
-        fwrite(msg.formatted.data() + start, sizeof(char), end - start, target_file_);
+        line_buffer_ << fmt::StringRef(msg.formatted.data() + start, end - start);
     }
     FILE *target_file_;
+    details::flush_tracker flush_tracker_;
+    fmt::MemoryWriter line_buffer_;
     bool should_do_colors_;
     std::unordered_map<level::level_enum, std::string, level::level_hasher> colors_;
 };
@@ -124,8 +150,8 @@ template<class Mutex>
 class ansicolor_stdout_sink : public ansicolor_sink<Mutex>
 {
 public:
-    ansicolor_stdout_sink()
-        : ansicolor_sink<Mutex>(stdout)
+    explicit ansicolor_stdout_sink(const flush_policy &policy = flush_policy::every_message())
+        : ansicolor_sink<Mutex>(stdout, policy)
     {
     }
 };
@@ -137,8 +163,8 @@ template<class Mutex>
 class ansicolor_stderr_sink : public ansicolor_sink<Mutex>
 {
 public:
-    ansicolor_stderr_sink()
-        : ansicolor_sink<Mutex>(stderr)
+    explicit ansicolor_stderr_sink(const flush_policy &policy = flush_policy::every_message())
+        : ansicolor_sink<Mutex>(stderr, policy)
     {
     }
 };
@@ -0,0 +1,284 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+#pragma once
+
+#include "../common.h"
+#include "../details/log_msg.h"
+#include "../details/mpmc_blocking_q.h"
+#include "../details/os.h"
+#include "sink.h"
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace spdlog {
+namespace sinks {
+
+/*
+ * Sink decorator giving the wrapped sink its own bounded queue and worker thread, so a slow sink (network, syslog...)
+ * delays only its own messages: the logger and its other sinks keep going. When the queue is full, the overflow
+ * policy either blocks the logging thread, or drops the message (counted in dropped()).
+ *
+ *     auto net = std::make_shared<spdlog::sinks::async_sink>(std::make_shared<spdlog::sinks::tcp_sink_mt>("host", 5000),
+ *         8192, spdlog::async_overflow_policy::discard_log_msg);
+ *     spdlog::logger logger("app", {file_sink, net});
+ *
+ * The messages are queued already formatted, with a copy of their text and logger name (and of the raw text only if
+ * the wrapped sink reads it, see sink::capture_flags()), so the loggers may be destroyed before their messages are
+ * written.
+ * flush() is queued as well, and never dropped: the wrapped sink flushes once it has written the messages logged
+ * before. The destructor writes the queued messages.
+ */
+class async_sink SPDLOG_FINAL : public sink
+{
+public:
+    explicit async_sink(
+        sink_ptr wrapped, size_t queue_size = 8192, async_overflow_policy overflow_policy = async_overflow_policy::block_retry)
+        : _wrapped(std::move(wrapped))
+        , _q(queue_size)
+        , _overflow_policy(overflow_policy)
+    {
+        _err_handler = [this](const std::string &msg) { this->_default_err_handler(msg); };
+        _worker_thread = std::thread(&async_sink::_worker_loop, this);
+    }
+
+    ~async_sink() override
+    {
+        try
+        {
+            _q.enqueue(queued_msg(queued_msg_type::terminate));
+            _worker_thread.join();
+        }
+        catch (...) // don't crash in destructor
+        {
+        }
+    }
+
+    async_sink(const async_sink &) = delete;
+    async_sink &operator=(const async_sink &) = delete;
+
+    void log(const details::log_msg &msg) override
+    {
+        if (_wrapped->should_log(msg.level))
+        {
+            _enqueue(queued_msg(msg, (_wrapped->capture_flags() & capture::raw) != 0));
+        }
+    }
+
+    // never dropped: blocks while the queue is full, whatever the overflow policy
+    void flush() override
+    {
+        _q.enqueue(queued_msg(queued_msg_type::flush));
+    }
+
+    unsigned capture_flags() const override
+    {
+        return _wrapped->capture_flags();
+    }
+
+    void set_formatter(formatter_ptr msg_formatter) override
+    {
+        _wrapped->set_formatter(std::move(msg_formatter));
+    }
+
+    const sink_ptr &wrapped() const
+    {
+        return _wrapped;
+    }
+
+    // number of messages waiting to be written
+    size_t queue_size()
+    {
+        return _q.size();
+    }
+
+    // number of messages dropped because the queue was full
+    size_t dropped() const
+    {
+        return _dropped.load(std::memory_order_relaxed);
+    }
+
+    // called in the worker thread with the errors of the wrapped sink. not thread safe: set it before logging.
+    void set_error_handler(log_err_handler err_handler)
+    {
+        _err_handler = std::move(err_handler);
+    }
+
+private:
+    enum class queued_msg_type
+    {
+        log,
+        flush,
+        terminate
+    };
+
+    struct queued_msg
+    {
+        queued_msg_type msg_type;
+        level::level_enum level;
+        log_clock::time_point time;
+#ifdef SPDLOG_CLOCK_TSC
+        uint64_t ticks;
+#endif
+        size_t thread_id;
+        size_t msg_id;
+        size_t color_range_start;
+        size_t color_range_end;
+        // the formatted text, the raw text if the wrapped sink reads it, then the logger name
+        std::string text;
+        size_t formatted_size;
+        size_t raw_size;
+        bool has_logger_name;
+        source_loc source;
+
+        queued_msg() = default;
+
+        explicit queued_msg(queued_msg_type m_type)
+            : msg_type(m_type)
+            , level(level::info)
+            , thread_id(0)
+            , msg_id(0)
+            , color_range_start(0)
+            , color_range_end(0)
+            , formatted_size(0)
+            , raw_size(0)
+            , has_logger_name(false)
+        {
+        }
+
+        queued_msg(const details::log_msg &m, bool with_raw)
+            : msg_type(queued_msg_type::log)
+            , level(m.level)
+            , time(m.time)
+#ifdef SPDLOG_CLOCK_TSC
+            , ticks(m.ticks)
+#endif
+            , thread_id(m.thread_id)
+            , msg_id(m.msg_id)
+            , color_range_start(m.color_range_start)
+            , color_range_end(m.color_range_end)
+            , formatted_size(m.formatted.size())
+            , raw_size(with_raw ? m.raw.size() : 0)
+            , has_logger_name(m.logger_name != nullptr)
+            , source(m.source != nullptr ? *m.source : source_loc())
+        {
+            text.reserve(formatted_size + raw_size + (has_logger_name ? m.logger_name->size() : 0));
+            text.append(m.formatted.data(), formatted_size);
+            text.append(m.raw.data(), raw_size);
+            if (has_logger_name)
+            {
+                text.append(*m.logger_name);
+            }
+        }
+
+        queued_msg(queued_msg &&other) = default;
+        queued_msg &operator=(queued_msg &&other) = default;
+        queued_msg(const queued_msg &) = delete;
+        queued_msg &operator=(const queued_msg &) = delete;
+
+        // msg and logger_name keep their buffers between calls: no allocation once they are large enough
+        void fill_log_msg(details::log_msg &msg, std::string &logger_name)
+        {
+            if (has_logger_name)
+            {
+                logger_name.assign(text, formatted_size + raw_size, std::string::npos);
+                msg.logger_name = &logger_name;
+            }
+            else
+            {
+                msg.logger_name = nullptr;
+            }
+            msg.level = level;
+            msg.time = time;
+#ifdef SPDLOG_CLOCK_TSC
+            msg.ticks = ticks;
+#endif
+            msg.thread_id = thread_id;
+            msg.msg_id = msg_id;
+            msg.color_range_start = color_range_start;
+            msg.color_range_end = color_range_end;
+            msg.formatted.clear();
+            msg.formatted << fmt::StringRef(text.data(), formatted_size);
+            msg.raw.clear();
+            msg.raw << fmt::StringRef(text.data() + formatted_size, raw_size);
+            msg.source = &source;
+        }
+    };
+
+    void _enqueue(queued_msg &&msg)
+    {
+        if (_overflow_policy == async_overflow_policy::block_retry)
+        {
+            _q.enqueue(std::move(msg));
+        }
+        else if (!_q.enqueue_nowait(std::move(msg)))
+        {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void _worker_loop()
+    {
+        details::log_msg msg;
+        std::string logger_name;
+        for (;;)
+        {
+            queued_msg item;
+            if (!_q.dequeue_for(item, std::chrono::seconds(10)))
+            {
+                continue;
+            }
+            try
+            {
+                switch (item.msg_type)
+                {
+                case queued_msg_type::log:
+                    item.fill_log_msg(msg, logger_name);
+                    _wrapped->log(msg);
+                    break;
+                case queued_msg_type::flush:
+                    _wrapped->flush();
+                    break;
+                case queued_msg_type::terminate:
+                    _wrapped->flush();
+                    return;
+                }
+            }
+            SPDLOG_CATCH_AND_HANDLE
+        }
+    }
+
+    // print to stderr, at most once a minute
+    void _default_err_handler(const std::string &msg)
+    {
+        auto now = std::time(nullptr);
+        if (now - _last_err_time < 60)
+        {
+            return;
+        }
+        _last_err_time = now;
+        auto tm_time = details::os::localtime(now);
+        char date_buf[100];
+        std::strftime(date_buf, sizeof(date_buf), "%Y-%m-%d %H:%M:%S", &tm_time);
+        fmt::print(stderr, "[*** LOG ERROR ***] [{}] [async_sink] {}\n", date_buf, msg);
+    }
+
+    sink_ptr _wrapped;
+    details::mpmc_bounded_queue<queued_msg> _q;
+    const async_overflow_policy _overflow_policy;
+    std::atomic<size_t> _dropped{0};
+    log_err_handler _err_handler;
+    std::time_t _last_err_time{0};
+    std::thread _worker_thread;
+};
+
+} // namespace sinks
+} // namespace spdlog
@@ -0,0 +1,60 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+#pragma once
+
+#include "../binary_formatter.h"
+#include "../details/file_helper.h"
+#include "../details/null_mutex.h"
+#include "base_sink.h"
+
+#include <mutex>
+#include <string>
+
+namespace spdlog {
+namespace sinks {
+/*
+ * File sink writing messages in the compact binary format (see binary_formatter.h).
+ * Format strings and logger names are written once per file.
+ * The logger's own formatter output is ignored, so set its pattern to "" to skip text formatting altogether.
+ */
+template<class Mutex>
+class binary_file_sink SPDLOG_FINAL : public base_sink<Mutex>
+{
+public:
+    explicit binary_file_sink(const filename_t &filename, bool truncate = false)
+    {
+        _file_helper.open(filename, truncate);
+    }
+
+    unsigned capture_flags() const override
+    {
+        return capture::all;
+    }
+
+protected:
+    void _sink_it(const details::log_msg &msg) override
+    {
+        _buffer.clear();
+        _formatter.format(msg, _buffer);
+        _file_helper.write(_buffer.data(), _buffer.size());
+    }
+
+    void _flush() override
+    {
+        _file_helper.flush();
+    }
+
+private:
+    details::file_helper _file_helper;
+    binary_formatter _formatter;
+    fmt::MemoryWriter _buffer;
+};
+
+using binary_file_sink_mt = binary_file_sink<std::mutex>;
+using binary_file_sink_st = binary_file_sink<details::null_mutex>;
+
+} // namespace sinks
+} // namespace spdlog
@@ -0,0 +1,183 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+#pragma once
+
+#include "../common.h"
+#include "../details/log_msg.h"
+#include "../details/null_mutex.h"
+#include "../details/os.h"
+#include "base_sink.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace spdlog {
+namespace sinks {
+
+enum class callback_payload
+{
+    raw,      // the message text, without the logger's pattern
+    formatted // the logger's formatted text
+};
+
+// a message handed to the callback. the strings point into the sink's batch buffer: valid during the callback only.
+struct callback_record
+{
+    level::level_enum level;
+    log_clock::time_point time;
+    size_t thread_id;
+    fmt::StringRef logger_name;
+    fmt::StringRef payload;
+};
+
+/*
+ * Sink handing the messages to an in-process consumer (metrics, telemetry, a UI...) in batches: the messages are
+ * copied into a reusable buffer, and the callback receives an array of records every max_messages messages, or
+ * with the first message logged max_delay after the previous batch. flush() delivers the pending messages, so with
+ * an async logger created with a flush interval, the worker also delivers them when the logger goes idle.
+ *
+ * The callback runs under the sink's lock (in the async worker with an async logger) and must not log to this sink.
+ */
+template<class Mutex>
+class callback_sink SPDLOG_FINAL : public base_sink<Mutex>
+{
+public:
+    using batch_callback = std::function<void(const callback_record *records, size_t count)>;
+
+    explicit callback_sink(batch_callback callback, size_t max_messages = 128,
+        std::chrono::milliseconds max_delay = std::chrono::milliseconds::zero(),
+        callback_payload payload = callback_payload::raw)
+        : _callback(std::move(callback))
+        , _max_messages(max_messages == 0 ? 1 : max_messages)
+        , _max_delay(std::chrono::duration_cast<std::chrono::nanoseconds>(max_delay).count())
+        , _payload(payload)
+        , _last_delivery(details::os::coarse_steady_nanos())
+    {
+        _pending.reserve(_max_messages);
+        _records.reserve(_max_messages);
+    }
+
+    ~callback_sink() override
+    {
+        try
+        {
+            _deliver();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    unsigned capture_flags() const override
+    {
+        return capture::all;
+    }
+
+protected:
+    void _sink_it(const details::log_msg &msg) override
+    {
+        pending_record record;
+        record.level = msg.level;
+        record.time = msg.time;
+        record.thread_id = msg.thread_id;
+
+        // most messages come from the same logger: store its name once per batch
+        if (msg.logger_name != _last_logger || _pending.empty())
+        {
+            _last_logger = msg.logger_name;
+            _last_name_offset = _buffer.size();
+            _last_name_size = msg.logger_name != nullptr ? msg.logger_name->size() : 0;
+            if (_last_name_size != 0)
+            {
+                _buffer << fmt::StringRef(msg.logger_name->data(), _last_name_size);
+            }
+        }
+        record.name_offset = _last_name_offset;
+        record.name_size = _last_name_size;
+
+        auto &text = _payload == callback_payload::raw ? msg.raw : msg.formatted;
+        record.payload_offset = _buffer.size();
+        record.payload_size = text.size();
+        _buffer << fmt::StringRef(text.data(), text.size());
+        _pending.push_back(record);
+
+        if (_pending.size() >= _max_messages ||
+            (_max_delay != 0 && details::os::coarse_steady_nanos() - _last_delivery >= _max_delay))
+        {
+            _deliver();
+        }
+    }
+
+    void _flush() override
+    {
+        _deliver();
+    }
+
+private:
+    // offsets into _buffer, which may move while the batch fills up
+    struct pending_record
+    {
+        level::level_enum level;
+        log_clock::time_point time;
+        size_t thread_id;
+        size_t name_offset;
+        size_t name_size;
+        size_t payload_offset;
+        size_t payload_size;
+    };
+
+    void _deliver()
+    {
+        _last_delivery = details::os::coarse_steady_nanos();
+        if (_pending.empty())
+        {
+            return;
+        }
+        auto data = _buffer.data();
+        _records.clear();
+        for (auto &pending : _pending)
+        {
+            _records.push_back(callback_record{pending.level, pending.time, pending.thread_id,
+                fmt::StringRef(data + pending.name_offset, pending.name_size),
+                fmt::StringRef(data + pending.payload_offset, pending.payload_size)});
+        }
+        // start the next batch even if the callback throws
+        struct batch_reset
+        {
+            callback_sink &sink;
+            ~batch_reset()
+            {
+                sink._pending.clear();
+                sink._buffer.clear();
+                sink._last_logger = nullptr;
+            }
+        } reset{*this};
+        _callback(_records.data(), _records.size());
+    }
+
+    batch_callback _callback;
+    const size_t _max_messages;
+    const int64_t _max_delay;
+    const callback_payload _payload;
+    int64_t _last_delivery;
+
+    std::vector<pending_record> _pending;
+    std::vector<callback_record> _records;
+    fmt::MemoryWriter _buffer;
+    const std::string *_last_logger{nullptr};
+    size_t _last_name_offset{0};
+    size_t _last_name_size{0};
+};
+
+using callback_sink_mt = callback_sink<std::mutex>;
+using callback_sink_st = callback_sink<details::null_mutex>;
+
+} // namespace sinks
+} // namespace spdlog
@@ -7,67 +7,188 @@
 
 #include "../details/log_msg.h"
 #include "../details/null_mutex.h"
-#include "base_sink.h"
+#include "../details/rcu_domain.h"
+#include "../details/sink_dispatch.h"
 #include "sink.h"
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <vector>
 
 // Distribution sink (mux). Stores a vector of sinks which get called when log is called
+//
+// The vector is published as an immutable snapshot (see details/rcu_domain.h): logging reads it without locking,
+// adding or removing a sink copies it.
+// By default the messages reach the sinks one at a time, under the Mutex, so the sinks may be *_st ones.
+// With dist_sink_mode::concurrent, messages from different threads reach the sinks concurrently: each sink does its
+// own locking, so they must all be *_mt ones.
+//
+// add_sink(), remove_sink() and remove_all_sinks() return once no thread logs through the previous vector anymore:
+// they wait for the messages being passed to the sinks, i.e. for a slow sink (network, blocking console...) to return.
+// Change the sinks at startup or from a thread which can afford to wait, not from a sink or a latency critical path.
+//
+// API change: dist_sink no longer derives from base_sink. Classes deriving from it override log() and pass the
+// messages on with _sink_it(), and read the sinks with sinks() instead of the former protected _sinks vector.
 
 namespace spdlog {
 namespace sinks {
+
+enum class dist_sink_mode
+{
+    serialized, // one message at a time: the sinks may be *_st
+    concurrent  // messages from different threads reach the sinks concurrently: the sinks must be *_mt
+};
+
 template<class Mutex>
-class dist_sink : public base_sink<Mutex>
+class dist_sink : public sink
 {
 public:
-    explicit dist_sink()
-        : _sinks()
+    explicit dist_sink(dist_sink_mode mode = dist_sink_mode::serialized)
+        : _mode(mode)
+        , _snapshot(new snapshot(std::vector<std::shared_ptr<sink>>()))
     {
     }
+
+    ~dist_sink() override
+    {
+        delete _snapshot.load();
+    }
+
     dist_sink(const dist_sink &) = delete;
     dist_sink &operator=(const dist_sink &) = delete;
 
-protected:
-    std::vector<std::shared_ptr<sink>> _sinks;
+    void log(const details::log_msg &msg) override
+    {
+        _sink_it(msg);
+    }
+
+    void flush() override
+    {
+        details::rcu_domain::read_guard guard(_rcu);
+        _for_each_sink([](sink &sub_sink) { sub_sink.flush(); });
+    }
+
+    // passed to the sinks added so far
+    void set_formatter(formatter_ptr msg_formatter) override
+    {
+        details::rcu_domain::read_guard guard(_rcu);
+        _for_each_sink([&msg_formatter](sink &sub_sink) { sub_sink.set_formatter(msg_formatter); });
+    }
+
+    // sinks can be added later, so capture everything they might need
+    unsigned capture_flags() const override
+    {
+        return capture::all;
+    }
+
+    // a copy of the sinks added, in order
+    std::vector<std::shared_ptr<sink>> sinks()
+    {
+        details::rcu_domain::read_guard guard(_rcu);
+        return _snapshot.load(std::memory_order_acquire)->sinks;
+    }
+
+    void add_sink(std::shared_ptr<sink> sub_sink)
+    {
+        snapshot *old_snapshot;
+        {
+            std::lock_guard<Mutex> lock(_mutex);
+            auto sinks = _snapshot.load(std::memory_order_relaxed)->sinks;
+            sinks.push_back(std::move(sub_sink));
+            old_snapshot = publish(std::move(sinks));
+        }
+        retire(old_snapshot);
+    }
 
-    void _sink_it(const details::log_msg &msg) override
+    void remove_sink(std::shared_ptr<sink> sub_sink)
     {
-        for (auto &sink : _sinks)
+        snapshot *old_snapshot;
         {
-            if (sink->should_log(msg.level))
-            {
-                sink->log(msg);
-            }
+            std::lock_guard<Mutex> lock(_mutex);
+            auto sinks = _snapshot.load(std::memory_order_relaxed)->sinks;
+            sinks.erase(std::remove(sinks.begin(), sinks.end(), sub_sink), sinks.end());
+            old_snapshot = publish(std::move(sinks));
         }
+        retire(old_snapshot);
     }
 
-    void _flush() override
+    void remove_all_sinks()
     {
-        for (auto &sink : _sinks)
-            sink->flush();
+        snapshot *old_snapshot;
+        {
+            std::lock_guard<Mutex> lock(_mutex);
+            old_snapshot = publish(std::vector<std::shared_ptr<sink>>());
+        }
+        retire(old_snapshot);
     }
 
-public:
-    void add_sink(std::shared_ptr<sink> sink)
+protected:
+    // pass the message to the sinks accepting its level
+    void _sink_it(const details::log_msg &msg)
     {
-        std::lock_guard<Mutex> lock(base_sink<Mutex>::_mutex);
-        _sinks.push_back(sink);
+        details::rcu_domain::read_guard guard(_rcu);
+        auto lock = _sinks_lock();
+        _snapshot.load(std::memory_order_acquire)->dispatch.for_each(msg.level, [&msg](sink &sub_sink) { sub_sink.log(msg); });
     }
 
-    void remove_sink(std::shared_ptr<sink> sink)
+    // serializes changes of the sink vector
+    Mutex _mutex;
+
+private:
+    struct snapshot
     {
-        std::lock_guard<Mutex> lock(base_sink<Mutex>::_mutex);
-        _sinks.erase(std::remove(_sinks.begin(), _sinks.end(), sink), _sinks.end());
+        explicit snapshot(std::vector<std::shared_ptr<sink>> sinks_in)
+            : sinks(std::move(sinks_in))
+            , dispatch(sinks)
+        {
+        }
+
+        const std::vector<std::shared_ptr<sink>> sinks;
+        details::sink_dispatch_table dispatch;
+    };
+
+    // locked in serialized mode only
+    std::unique_lock<Mutex> _sinks_lock()
+    {
+        std::unique_lock<Mutex> lock(_sinks_mutex, std::defer_lock);
+        if (_mode == dist_sink_mode::serialized)
+        {
+            lock.lock();
+        }
+        return lock;
     }
 
-    void remove_all_sinks()
+    // call fun(sink) for each sink. must be called in a read side section.
+    template<class Fun>
+    void _for_each_sink(Fun fun)
     {
-        std::lock_guard<Mutex> lock(base_sink<Mutex>::_mutex);
-        _sinks.clear();
+        auto lock = _sinks_lock();
+        for (auto &sub_sink : _snapshot.load(std::memory_order_acquire)->sinks)
+        {
+            fun(*sub_sink);
+        }
     }
+
+    // replace the snapshot. return the old one, to retire() after releasing _mutex.
+    snapshot *publish(std::vector<std::shared_ptr<sink>> sinks)
+    {
+        return _snapshot.exchange(new snapshot(std::move(sinks)), std::memory_order_acq_rel);
+    }
+
+    // free the old snapshot once no thread logs through it
+    void retire(snapshot *old_snapshot)
+    {
+        _rcu.synchronize();
+        delete old_snapshot;
+    }
+
+    const dist_sink_mode _mode;
+    // serializes the calls to the sinks in serialized mode
+    Mutex _sinks_mutex;
+    details::rcu_domain _rcu;
+    std::atomic<snapshot *> _snapshot;
 };
 
 using dist_sink_mt = dist_sink<std::mutex>;
@@ -0,0 +1,127 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+#pragma once
+
+#include "../details/log_msg.h"
+#include "../details/null_mutex.h"
+#include "../formatter.h"
+#include "dist_sink.h"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Duplicate message removing sink.
+// Skip the message if it is identical to the previous one (same level and payload) and less than max_skip_duration
+// passed since the first of the run.
+// When a different message arrives, a "Skipped N duplicate messages.." message is logged before it,
+// formatted with the formatter of the logger (see sink::set_formatter()).
+// Payloads are compared by a hash of the raw message.
+// Unlike dist_sink, messages are filtered under the Mutex.
+//
+// Example:
+//
+//     auto dup_filter = std::make_shared<dup_filter_sink_st>(std::chrono::seconds(5));
+//     dup_filter->add_sink(std::make_shared<stdout_sink_mt>());
+//     spdlog::logger l("logger", dup_filter);
+//     l.info("Hello");
+//     l.info("Hello");
+//     l.info("Hello");
+//     l.info("Different Hello");
+//
+// Will produce:
+//       [2018-10-19 14:30:54.365] [logger] [info] Hello
+//       [2018-10-19 14:30:54.365] [logger] [info] Skipped 2 duplicate messages..
+//       [2018-10-19 14:30:54.365] [logger] [info] Different Hello
+
+namespace spdlog {
+namespace sinks {
+template<class Mutex>
+class dup_filter_sink : public dist_sink<Mutex>
+{
+public:
+    template<class Rep, class Period>
+    explicit dup_filter_sink(std::chrono::duration<Rep, Period> max_skip_duration)
+        : _max_skip_duration(std::chrono::duration_cast<log_clock::duration>(max_skip_duration))
+        , _formatter(std::make_shared<pattern_formatter>("%+"))
+    {
+    }
+
+    void set_formatter(formatter_ptr msg_formatter) override
+    {
+        {
+            std::lock_guard<Mutex> lock(_filter_mutex);
+            _formatter = msg_formatter;
+        }
+        dist_sink<Mutex>::set_formatter(std::move(msg_formatter));
+    }
+
+    void log(const details::log_msg &msg) override
+    {
+        std::lock_guard<Mutex> lock(_filter_mutex);
+        auto hash = payload_hash(msg);
+        bool duplicate = _run_length != 0 && hash == _last_hash && msg.level == _last_level && msg.time - _run_start < _max_skip_duration;
+        if (duplicate)
+        {
+            _run_length++;
+            return;
+        }
+
+        log_skipped(msg);
+        _run_length = 1;
+        _last_hash = hash;
+        _last_level = msg.level;
+        _run_start = msg.time;
+        dist_sink<Mutex>::_sink_it(msg);
+    }
+
+private:
+    // log "Skipped N duplicate messages.." if the run that just ended had duplicates
+    void log_skipped(const details::log_msg &msg)
+    {
+        if (_run_length <= 1)
+        {
+            return;
+        }
+        details::log_msg skipped_msg(msg.logger_name, _last_level, capture::none);
+        skipped_msg.time = msg.time;
+        skipped_msg.thread_id = msg.thread_id;
+        skipped_msg.raw << "Skipped " << _run_length - 1 << " duplicate messages..";
+        _formatter->format(skipped_msg);
+        dist_sink<Mutex>::_sink_it(skipped_msg);
+    }
+
+    // 64 bit FNV-1a
+    static uint64_t payload_hash(const details::log_msg &msg)
+    {
+        uint64_t hash = 14695981039346656037ULL;
+        auto data = msg.raw.data();
+        for (size_t i = 0; i < msg.raw.size(); i++)
+        {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    // guards the state below
+    Mutex _filter_mutex;
+    const log_clock::duration _max_skip_duration;
+    formatter_ptr _formatter;
+    // number of messages in the current run of identical messages (0 before the first message)
+    size_t _run_length{0};
+    uint64_t _last_hash{0};
+    level::level_enum _last_level{level::off};
+    log_clock::time_point _run_start;
+};
+
+using dup_filter_sink_mt = dup_filter_sink<std::mutex>;
+using dup_filter_sink_st = dup_filter_sink<details::null_mutex>;
+
+} // namespace sinks
+} // namespace spdlog
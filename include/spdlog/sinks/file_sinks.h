@@ -38,6 +38,11 @@ public:
         _force_flush = force_flush;
     }
 
+    unsigned capture_flags() const override
+    {
+        return capture::none;
+    }
+
 protected:
     void _sink_it(const details::log_msg &msg) override
     {
@@ -95,6 +100,11 @@ public:
         return w.str();
     }
 
+    unsigned capture_flags() const override
+    {
+        return capture::none;
+    }
+
 protected:
     void _sink_it(const details::log_msg &msg) override
     {
@@ -208,6 +218,11 @@ public:
         _file_helper.open(FileNameCalc::calc_filename(_base_filename));
     }
 
+    unsigned capture_flags() const override
+    {
+        return capture::none;
+    }
+
 protected:
     void _sink_it(const details::log_msg &msg) override
     {
@@ -0,0 +1,122 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+#pragma once
+
+// When the console sinks flush their FILE stream.
+// Flushing after each message (the default) costs a write syscall per line, which is expensive when the output is
+// a pipe or a file (e.g. services under systemd or in containers). The other policies let stdio buffer the output:
+//
+//     flush_policy::every_message()                           - flush after each message
+//     flush_policy::every_bytes(64 * 1024)                    - flush once 64KB were written since the last flush
+//     flush_policy::every_interval(std::chrono::seconds(1))   - flush the first message written 1s after the last flush
+//     flush_policy::on_level(level::warn)                     - flush after messages at warn or above
+//
+// The fields can be combined: the sink flushes when any of the conditions is met.
+// The conditions are checked when a message is written. logger::flush() and flush_on() flush regardless.
+// So with every_interval, the last messages before the logger goes idle stay buffered until the next message:
+// flush them with the async loggers' flush_interval_ms (which an idle worker checks at least every 2 seconds),
+// or by calling logger::flush() periodically.
+
+#include "../common.h"
+#include "../details/os.h"
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+namespace spdlog {
+namespace sinks {
+
+struct flush_policy
+{
+    static flush_policy every_message()
+    {
+        return flush_policy();
+    }
+
+    static flush_policy every_bytes(size_t bytes)
+    {
+        flush_policy policy;
+        policy.max_bytes = bytes;
+        return policy;
+    }
+
+    static flush_policy every_interval(std::chrono::milliseconds interval)
+    {
+        flush_policy policy;
+        policy.max_bytes = std::numeric_limits<size_t>::max();
+        policy.max_interval = interval;
+        return policy;
+    }
+
+    static flush_policy on_level(level::level_enum lvl)
+    {
+        flush_policy policy;
+        policy.max_bytes = std::numeric_limits<size_t>::max();
+        policy.flush_level = lvl;
+        return policy;
+    }
+
+    // flush once at least max_bytes were written since the last flush (0: after each message)
+    size_t max_bytes{0};
+    // flush the first message written max_interval after the last flush (zero: no interval)
+    std::chrono::milliseconds max_interval{std::chrono::milliseconds::zero()};
+    // flush after messages at this level or above (off: never)
+    level::level_enum flush_level{level::off};
+};
+
+} // namespace sinks
+
+namespace details {
+
+// the state of a flush_policy for one sink. not thread safe: used under the sink's mutex.
+class flush_tracker
+{
+public:
+    explicit flush_tracker(const sinks::flush_policy &policy)
+        : _policy(policy)
+        , _last_flush(os::coarse_steady_nanos())
+    {
+    }
+
+    // record a message of the given size written to the stream. return true if the stream should be flushed now.
+    bool should_flush(level::level_enum msg_level, size_t size)
+    {
+        _unflushed_bytes += size;
+        if (_unflushed_bytes >= _policy.max_bytes || (msg_level >= _policy.flush_level && _policy.flush_level != level::off))
+        {
+            return true;
+        }
+        if (_policy.max_interval == std::chrono::milliseconds::zero())
+        {
+            return false;
+        }
+        auto interval = std::chrono::duration_cast<std::chrono::nanoseconds>(_policy.max_interval).count();
+        return os::coarse_steady_nanos() - _last_flush >= interval;
+    }
+
+    void flushed()
+    {
+        _unflushed_bytes = 0;
+        if (_policy.max_interval != std::chrono::milliseconds::zero())
+        {
+            _last_flush = os::coarse_steady_nanos();
+        }
+    }
+
+    void set_policy(const sinks::flush_policy &policy)
+    {
+        _policy = policy;
+    }
+
+private:
+    sinks::flush_policy _policy;
+    size_t _unflushed_bytes{0};
+    int64_t _last_flush;
+};
+
+} // namespace details
+} // namespace spdlog
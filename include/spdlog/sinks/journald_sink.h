@@ -0,0 +1,297 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+#pragma once
+
+#ifdef __linux__
+
+#include "../common.h"
+#include "../details/log_msg.h"
+#include "../details/net.h"
+#include "../details/null_mutex.h"
+#include "../details/os.h"
+#include "base_sink.h"
+
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+namespace spdlog {
+namespace sinks {
+
+/**
+ * Sink that sends entries to systemd-journald over its native protocol, keeping the metadata as journal fields:
+ * MESSAGE (the message text, without the logger's pattern), PRIORITY, SYSLOG_IDENTIFIER, TID, SPDLOG_LOGGER,
+ * CODE_FILE, CODE_LINE and CODE_FUNC (when the source location is known, see the SPDLOG_<LEVEL> macros),
+ * plus the custom fields added with add_field().
+ *
+ * Each entry is one datagram, sent with sendmsg() from iovecs pointing at the message. Entries larger than the
+ * socket accepts are passed in a sealed memfd instead, as done by sd_journal_send().
+ * The socket is non blocking: entries which cannot be sent right away are dropped and counted in dropped().
+ */
+template<class Mutex>
+class journald_sink : public base_sink<Mutex>
+{
+public:
+    explicit journald_sink(std::string identifier = "", std::string socket_path = "/run/systemd/journal/socket")
+        : _socket_path(std::move(socket_path))
+    {
+        _identifier = identifier.empty() ? program_invocation_short_name : identifier;
+        _build_prefix();
+        if (!_connect())
+        {
+            throw spdlog_ex("Failed connecting to journald socket " + _socket_path, errno);
+        }
+    }
+
+    ~journald_sink() override
+    {
+        details::net::close_socket(_fd);
+    }
+
+    // add a field to all the entries. the name is made of uppercase letters, digits and underscores, and does not
+    // start with an underscore (reserved to journald).
+    void add_field(const std::string &name, const std::string &value)
+    {
+        if (!valid_field_name(name))
+        {
+            throw spdlog_ex("Invalid journal field name " + name);
+        }
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::_mutex);
+        _fields.emplace_back(name, value);
+        _build_prefix();
+    }
+
+    // number of entries dropped because the socket was busy or could not be written
+    size_t dropped()
+    {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::_mutex);
+        return _dropped;
+    }
+
+    unsigned capture_flags() const override
+    {
+        return capture::thread_id | capture::raw;
+    }
+
+    static bool valid_field_name(const std::string &name)
+    {
+        if (name.empty() || name.size() > 64 || name[0] == '_' || (name[0] >= '0' && name[0] <= '9'))
+        {
+            return false;
+        }
+        for (auto c : name)
+        {
+            if (!((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_'))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+protected:
+    void _sink_it(const details::log_msg &msg) override
+    {
+        static const int priorities[] = {
+            7, // trace: LOG_DEBUG
+            7, // debug: LOG_DEBUG
+            6, // info: LOG_INFO
+            4, // warn: LOG_WARNING
+            3, // err: LOG_ERR
+            2, // critical: LOG_CRIT
+            6, // off: LOG_INFO
+        };
+
+        // the short fields, then the message sent from its own buffer
+        _fields_buffer.clear();
+        _fields_buffer << "PRIORITY=" << priorities[msg.level] << "\nTID=" << msg.thread_id << '\n';
+        if (msg.logger_name != nullptr)
+        {
+            append_field(_fields_buffer, "SPDLOG_LOGGER", msg.logger_name->data(), msg.logger_name->size());
+        }
+        if (msg.source != nullptr && !msg.source->empty())
+        {
+            append_field(_fields_buffer, "CODE_FILE", msg.source->filename, std::strlen(msg.source->filename));
+            _fields_buffer << "CODE_LINE=" << msg.source->line << '\n';
+            append_field(_fields_buffer, "CODE_FUNC", msg.source->funcname, std::strlen(msg.source->funcname));
+        }
+
+        _iov.clear();
+        _add_iov(_prefix.data(), _prefix.size());
+        _add_iov(_fields_buffer.data(), _fields_buffer.size());
+        auto text = msg.raw.data();
+        auto size = msg.raw.size();
+        if (std::memchr(text, '\n', size) == nullptr)
+        {
+            _add_iov("MESSAGE=", 8);
+            _add_iov(text, size);
+        }
+        else
+        {
+            // values with newlines are sent as the name, a newline, the value's size (64 bit little endian), the value
+            encode_size(size, _message_size);
+            _add_iov("MESSAGE\n", 8);
+            _add_iov(_message_size, sizeof(_message_size));
+            _add_iov(text, size);
+        }
+        _add_iov("\n", 1);
+        _send();
+    }
+
+    void _flush() override {}
+
+private:
+    static void encode_size(uint64_t size, char *dest)
+    {
+        for (int i = 0; i < 8; i++)
+        {
+            dest[i] = static_cast<char>((size >> (8 * i)) & 0xff);
+        }
+    }
+
+    static void append_field(fmt::MemoryWriter &dest, const char *name, const char *value, size_t size)
+    {
+        if (std::memchr(value, '\n', size) == nullptr)
+        {
+            dest << name << '=' << fmt::StringRef(value, size) << '\n';
+            return;
+        }
+        char encoded_size[8];
+        encode_size(size, encoded_size);
+        dest << name << '\n' << fmt::StringRef(encoded_size, sizeof(encoded_size)) << fmt::StringRef(value, size) << '\n';
+    }
+
+    // the fields common to all the entries
+    void _build_prefix()
+    {
+        fmt::MemoryWriter prefix;
+        append_field(prefix, "SYSLOG_IDENTIFIER", _identifier.data(), _identifier.size());
+        for (auto &field : _fields)
+        {
+            append_field(prefix, field.first.c_str(), field.second.data(), field.second.size());
+        }
+        _prefix = prefix.str();
+    }
+
+    void _add_iov(const char *data, size_t size)
+    {
+        struct iovec iov;
+        iov.iov_base = const_cast<char *>(data);
+        iov.iov_len = size;
+        _iov.push_back(iov);
+    }
+
+    void _send()
+    {
+        struct msghdr mh;
+        std::memset(&mh, 0, sizeof(mh));
+        mh.msg_iov = _iov.data();
+        mh.msg_iovlen = _iov.size();
+        bool reconnected = false;
+        for (;;)
+        {
+            if (_fd != -1 && ::sendmsg(_fd, &mh, MSG_NOSIGNAL) != -1)
+            {
+                return;
+            }
+            auto err = _fd == -1 ? ENOTCONN : errno;
+            if (err == EINTR)
+            {
+                continue;
+            }
+            if ((err == EMSGSIZE || err == ENOBUFS) && _send_memfd())
+            {
+                return;
+            }
+            if ((err == ECONNREFUSED || err == ENOTCONN || err == ENOENT) && !reconnected)
+            {
+                // journald restarted
+                reconnected = true;
+                details::net::close_socket(_fd);
+                if (_connect())
+                {
+                    continue;
+                }
+            }
+            ++_dropped;
+            return;
+        }
+    }
+
+    // pass the entry in a sealed memory file, for entries larger than a datagram. return false on failure.
+    bool _send_memfd()
+    {
+        int memfd = ::memfd_create("spdlog-journald", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+        if (memfd == -1)
+        {
+            return false;
+        }
+        size_t total = 0;
+        for (auto &iov : _iov)
+        {
+            total += iov.iov_len;
+        }
+        auto written = ::writev(memfd, _iov.data(), static_cast<int>(_iov.size()));
+        if (written < 0 || static_cast<size_t>(written) != total ||
+            ::fcntl(memfd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) != 0)
+        {
+            ::close(memfd);
+            return false;
+        }
+
+        union
+        {
+            struct cmsghdr align;
+            char buf[CMSG_SPACE(sizeof(int))];
+        } control;
+        std::memset(&control, 0, sizeof(control));
+        struct msghdr mh;
+        std::memset(&mh, 0, sizeof(mh));
+        mh.msg_control = control.buf;
+        mh.msg_controllen = sizeof(control.buf);
+        auto cmsg = CMSG_FIRSTHDR(&mh);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+        std::memcpy(CMSG_DATA(cmsg), &memfd, sizeof(int));
+
+        auto sent = ::sendmsg(_fd, &mh, MSG_NOSIGNAL) != -1;
+        ::close(memfd);
+        return sent;
+    }
+
+    bool _connect()
+    {
+        _fd = details::net::connect_nonblocking(details::net::unix_address(_socket_path), SOCK_DGRAM);
+        return _fd != -1;
+    }
+
+    const std::string _socket_path;
+    std::string _identifier;
+    std::vector<std::pair<std::string, std::string>> _fields;
+    std::string _prefix;
+    int _fd{-1};
+    size_t _dropped{0};
+
+    fmt::MemoryWriter _fields_buffer;
+    char _message_size[8];
+    std::vector<struct iovec> _iov;
+};
+
+using journald_sink_mt = journald_sink<std::mutex>;
+using journald_sink_st = journald_sink<details::null_mutex>;
+
+} // namespace sinks
+} // namespace spdlog
+
+#endif // __linux__
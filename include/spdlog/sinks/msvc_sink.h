@@ -26,6 +26,11 @@ class msvc_sink : public base_sink<Mutex>
 public:
     explicit msvc_sink() {}
 
+    unsigned capture_flags() const override
+    {
+        return capture::none;
+    }
+
 protected:
     void _sink_it(const details::log_msg &msg) override
     {
@@ -0,0 +1,244 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+#pragma once
+
+#ifndef _WIN32
+
+#include "../common.h"
+#include "../details/datagram_batch.h"
+#include "../details/log_msg.h"
+#include "../details/net.h"
+#include "../details/null_mutex.h"
+#include "../details/os.h"
+#include "base_sink.h"
+#include "flush_policy.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace spdlog {
+namespace sinks {
+
+enum class syslog_format
+{
+    rfc3164, // <PRI>Mmm dd hh:mm:ss ident[pid]: msg (what libc's syslog() sends)
+    rfc5424  // <PRI>1 yyyy-mm-ddThh:mm:ss.uuuuuuZ host ident pid - - msg
+};
+
+/**
+ * Sink that sends syslog datagrams directly to the local syslog socket (/dev/log by default),
+ * without going through libc's syslog() (no global lock, no temporary string per message).
+ *
+ * The socket is non blocking: if the syslog daemon does not keep up (EAGAIN), messages are dropped rather than
+ * blocking the logging thread, and counted in dropped(). If the daemon restarted, the socket is reconnected.
+ *
+ * Messages are sent according to the flush_policy: after each message by default, or batched and sent together
+ * (with a single sendmmsg() call on Linux) when the policy triggers, the batch is full or on flush().
+ * Batching suits async loggers: set their flush interval to bound the delay of the last messages.
+ */
+template<class Mutex>
+class native_syslog_sink : public base_sink<Mutex>
+{
+public:
+    // messages kept in a batch before it is sent regardless of the flush policy
+    static const size_t max_batch = details::datagram_batch::max_datagrams;
+
+    explicit native_syslog_sink(std::string ident = "", int syslog_facility = (1 << 3), std::string socket_path = "/dev/log",
+        syslog_format format = syslog_format::rfc3164, const flush_policy &policy = flush_policy::every_message())
+        : _ident(std::move(ident))
+        , _facility(syslog_facility)
+        , _socket_path(std::move(socket_path))
+        , _format(format)
+        , _flush_tracker(policy)
+    {
+        if (_ident.empty())
+        {
+#ifdef __linux__
+            _ident = program_invocation_short_name;
+#else
+            _ident = getprogname();
+#endif
+        }
+        char host[256] = {};
+        if (::gethostname(host, sizeof(host) - 1) != 0 || host[0] == '\0')
+        {
+            std::strcpy(host, "-");
+        }
+        _hostname = host;
+        if (!_connect())
+        {
+            throw spdlog_ex("Failed connecting to syslog socket " + _socket_path, errno);
+        }
+    }
+
+    ~native_syslog_sink() override
+    {
+        try
+        {
+            _send_batch();
+        }
+        catch (...)
+        {
+        }
+        details::net::close_socket(_fd);
+    }
+
+    void set_flush_policy(const flush_policy &policy)
+    {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::_mutex);
+        _flush_tracker.set_policy(policy);
+    }
+
+    // number of messages dropped because the socket was busy or could not be written
+    size_t dropped()
+    {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::_mutex);
+        return _dropped;
+    }
+
+    unsigned capture_flags() const override
+    {
+        return capture::time | capture::raw;
+    }
+
+protected:
+    void _sink_it(const details::log_msg &msg) override
+    {
+        _batch.start();
+        _write_header(msg);
+        _batch.writer() << fmt::StringRef(msg.raw.data(), msg.raw.size());
+        auto size = _batch.finish();
+        if (_batch.full() || _flush_tracker.should_flush(msg.level, size))
+        {
+            _flush();
+        }
+    }
+
+    void _flush() override
+    {
+        _send_batch();
+        _flush_tracker.flushed();
+    }
+
+private:
+    int _priority(level::level_enum lvl) const
+    {
+        static const int severities[] = {
+            7, // trace: LOG_DEBUG
+            7, // debug: LOG_DEBUG
+            6, // info: LOG_INFO
+            4, // warn: LOG_WARNING
+            3, // err: LOG_ERR
+            2, // critical: LOG_CRIT
+            6, // off: LOG_INFO
+        };
+        return _facility | severities[lvl];
+    }
+
+    void _write_header(const details::log_msg &msg)
+    {
+        auto seconds = log_clock::to_time_t(msg.time);
+        if (seconds != _cached_seconds)
+        {
+            // the timestamp up to the seconds changes at most once per second
+            _cached_seconds = seconds;
+            char buf[64];
+            if (_format == syslog_format::rfc3164)
+            {
+                auto tm = details::os::localtime(seconds);
+                _cached_timestamp.assign(buf, std::strftime(buf, sizeof(buf), "%b %e %H:%M:%S", &tm));
+            }
+            else
+            {
+                auto tm = details::os::gmtime(seconds);
+                _cached_timestamp.assign(buf, std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", &tm));
+            }
+        }
+
+        auto &w = _batch.writer();
+        w << '<' << _priority(msg.level) << '>';
+        if (_format == syslog_format::rfc3164)
+        {
+            w << _cached_timestamp << ' ' << _ident << '[' << details::os::pid() << "]: ";
+        }
+        else
+        {
+            auto micros = std::chrono::duration_cast<std::chrono::microseconds>(msg.time.time_since_epoch()).count() % 1000000;
+            w << "1 " << _cached_timestamp << '.' << fmt::pad(static_cast<unsigned>(micros), 6, '0') << "Z " << _hostname << ' '
+                   << _ident << ' ' << details::os::pid() << " - - ";
+        }
+    }
+
+    void _send_batch()
+    {
+        bool reconnected = false;
+        while (!_batch.send(_fd))
+        {
+            auto err = errno;
+            if (err == EINTR)
+            {
+                continue;
+            }
+            if (err == EAGAIN || err == EWOULDBLOCK)
+            {
+                // the daemon does not keep up: drop the rest instead of blocking
+                break;
+            }
+            if ((err == ECONNREFUSED || err == ENOTCONN || err == ENOENT || err == EBADF) && !reconnected)
+            {
+                // the daemon restarted
+                reconnected = true;
+                details::net::close_socket(_fd);
+                if (_connect())
+                {
+                    continue;
+                }
+                break;
+            }
+            // this datagram cannot be sent (e.g. too large), skip it
+            _batch.drop_first();
+            ++_dropped;
+        }
+        _dropped += _batch.pending();
+        _batch.clear();
+    }
+
+    bool _connect()
+    {
+        _fd = details::net::connect_nonblocking(details::net::unix_address(_socket_path), SOCK_DGRAM);
+        return _fd != -1;
+    }
+
+    std::string _ident;
+    std::string _hostname;
+    const int _facility;
+    const std::string _socket_path;
+    const syslog_format _format;
+    details::flush_tracker _flush_tracker;
+    int _fd{-1};
+    size_t _dropped{0};
+
+    details::datagram_batch _batch;
+
+    std::time_t _cached_seconds{0};
+    std::string _cached_timestamp;
+};
+
+template<class Mutex>
+const size_t native_syslog_sink<Mutex>::max_batch;
+
+using native_syslog_sink_mt = native_syslog_sink<std::mutex>;
+using native_syslog_sink_st = native_syslog_sink<details::null_mutex>;
+
+} // namespace sinks
+} // namespace spdlog
+
+#endif // _WIN32
@@ -16,6 +16,12 @@ namespace sinks {
 template<class Mutex>
 class null_sink : public base_sink<Mutex>
 {
+public:
+    unsigned capture_flags() const override
+    {
+        return capture::none;
+    }
+
 protected:
     void _sink_it(const details::log_msg &) override {}
 
@@ -25,6 +25,11 @@ public:
     ostream_sink(const ostream_sink &) = delete;
     ostream_sink &operator=(const ostream_sink &) = delete;
 
+    unsigned capture_flags() const override
+    {
+        return capture::none;
+    }
+
 protected:
     void _sink_it(const details::log_msg &msg) override
     {
@@ -0,0 +1,199 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+#pragma once
+
+#include "../common.h"
+#include "../details/log_msg.h"
+#include "../details/null_mutex.h"
+#include "base_sink.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace spdlog {
+namespace sinks {
+
+/*
+ * Sink keeping the last formatted messages in memory, e.g. for an admin endpoint showing the recent logs.
+ * It retains at most max_messages messages, and at most max_bytes of text: the oldest messages are evicted to make
+ * room. Both buffers are allocated upfront: logging is a copy, without allocation.
+ *
+ * last_formatted() takes no lock, so taking a snapshot never blocks the loggers (nor the loggers the snapshot):
+ * it copies the messages, then keeps those which were not evicted during the copy. The text is stored in atomic words
+ * for that, copied with relaxed loads and stores.
+ */
+template<class Mutex>
+class ringbuffer_sink SPDLOG_FINAL : public base_sink<Mutex>
+{
+public:
+    explicit ringbuffer_sink(size_t max_messages, size_t max_bytes = 1024 * 1024)
+        : _max_messages(max_messages)
+        , _capacity(max_bytes)
+    {
+        if (max_messages == 0 || max_bytes == 0)
+        {
+            throw spdlog_ex("ringbuffer_sink: the maximum number of messages and bytes must be positive");
+        }
+        _slots.reset(new slot[max_messages]);
+        _text.reset(new std::atomic<uint64_t>[(max_bytes + word_size - 1) / word_size]());
+    }
+
+    // the retained messages, oldest first. at most the last limit ones if limit is not 0.
+    std::vector<std::string> last_formatted(size_t limit = 0) const
+    {
+        auto next = _next.load(std::memory_order_acquire);
+        auto head = std::min(_head.load(std::memory_order_relaxed), next);
+        if (limit != 0 && next - head > limit)
+        {
+            head = next - limit;
+        }
+
+        // copy the slots, then keep those which were not reused meanwhile
+        std::vector<std::pair<uint64_t, size_t>> slots;
+        slots.reserve(static_cast<size_t>(next - head));
+        for (auto seq = head; seq < next; seq++)
+        {
+            auto &s = _slots[seq % _max_messages];
+            slots.emplace_back(s.offset.load(std::memory_order_relaxed), s.size.load(std::memory_order_relaxed));
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        auto valid = _valid_from(head, next);
+        std::vector<std::string> messages;
+        if (valid == next)
+        {
+            return messages;
+        }
+        slots.erase(slots.begin(), slots.begin() + static_cast<ptrdiff_t>(valid - head));
+        head = valid;
+
+        // copy the text, then keep the messages which were not overwritten meanwhile
+        auto begin = slots.front().first;
+        auto size = static_cast<size_t>(std::min<uint64_t>(slots.back().first + slots.back().second - begin, _capacity));
+        std::string text(size, '\0');
+        auto offset = static_cast<size_t>(begin % _capacity);
+        auto first_part = std::min(size, _capacity - offset);
+        _load_text(offset, &text[0], first_part);
+        _load_text(0, &text[0] + first_part, size - first_part);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        valid = _valid_from(head, next);
+
+        messages.reserve(static_cast<size_t>(next - valid));
+        for (auto i = static_cast<size_t>(valid - head); i < slots.size(); i++)
+        {
+            messages.emplace_back(text, static_cast<size_t>(slots[i].first - begin), slots[i].second);
+        }
+        return messages;
+    }
+
+    unsigned capture_flags() const override
+    {
+        return capture::none;
+    }
+
+protected:
+    void _sink_it(const details::log_msg &msg) override
+    {
+        auto size = std::min(msg.formatted.size(), _capacity);
+        auto next = _next.load(std::memory_order_relaxed);
+        auto head = _head.load(std::memory_order_relaxed);
+
+        // evict the oldest messages to make room
+        auto new_head = head;
+        while (new_head < next &&
+               (next - new_head >= _max_messages ||
+                   _write_pos + size - _slots[new_head % _max_messages].offset.load(std::memory_order_relaxed) > _capacity))
+        {
+            new_head++;
+        }
+        if (new_head != head)
+        {
+            _head.store(new_head, std::memory_order_relaxed);
+            // readers must see the new head before any overwritten slot or text
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+
+        auto &s = _slots[next % _max_messages];
+        s.offset.store(_write_pos, std::memory_order_relaxed);
+        s.size.store(size, std::memory_order_relaxed);
+        auto offset = static_cast<size_t>(_write_pos % _capacity);
+        auto first_part = std::min(size, _capacity - offset);
+        _store_text(offset, msg.formatted.data(), first_part);
+        _store_text(0, msg.formatted.data() + first_part, size - first_part);
+        _write_pos += size;
+        _next.store(next + 1, std::memory_order_release);
+    }
+
+    void _flush() override {}
+
+private:
+    static const size_t word_size = sizeof(uint64_t);
+
+    struct slot
+    {
+        std::atomic<uint64_t> offset{0};
+        std::atomic<size_t> size{0};
+    };
+
+    // the first message still valid
+    uint64_t _valid_from(uint64_t head, uint64_t next) const
+    {
+        return std::min(std::max(head, _head.load(std::memory_order_relaxed)), next);
+    }
+
+    // copy size bytes of data to the text at offset, without wrapping
+    void _store_text(size_t offset, const char *data, size_t size)
+    {
+        while (size != 0)
+        {
+            auto &word = _text[offset / word_size];
+            auto in_word = offset % word_size;
+            auto n = std::min(size, word_size - in_word);
+            uint64_t value = n == word_size ? 0 : word.load(std::memory_order_relaxed);
+            std::memcpy(reinterpret_cast<char *>(&value) + in_word, data, n);
+            word.store(value, std::memory_order_relaxed);
+            offset += n;
+            data += n;
+            size -= n;
+        }
+    }
+
+    // copy size bytes of the text at offset to data, without wrapping
+    void _load_text(size_t offset, char *data, size_t size) const
+    {
+        while (size != 0)
+        {
+            auto in_word = offset % word_size;
+            auto n = std::min(size, word_size - in_word);
+            uint64_t value = _text[offset / word_size].load(std::memory_order_relaxed);
+            std::memcpy(data, reinterpret_cast<const char *>(&value) + in_word, n);
+            offset += n;
+            data += n;
+            size -= n;
+        }
+    }
+
+    const size_t _max_messages;
+    const size_t _capacity;
+    std::unique_ptr<slot[]> _slots;
+    std::unique_ptr<std::atomic<uint64_t>[]> _text;
+    // sequence numbers of the oldest message retained, and of the next message
+    std::atomic<uint64_t> _head{0};
+    std::atomic<uint64_t> _next{0};
+    // position of the next message in the text, counting from the first message. used by the writers only.
+    uint64_t _write_pos{0};
+};
+
+using ringbuffer_sink_mt = ringbuffer_sink<std::mutex>;
+using ringbuffer_sink_st = ringbuffer_sink<details::null_mutex>;
+
+} // namespace sinks
+} // namespace spdlog
@@ -0,0 +1,155 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+#pragma once
+
+#ifndef _WIN32
+
+#include "../binary_formatter.h"
+#include "../details/log_msg.h"
+#include "../details/null_mutex.h"
+#include "../details/shm_ring.h"
+#include "base_sink.h"
+
+#include <mutex>
+#include <string>
+
+namespace spdlog {
+namespace sinks {
+
+enum class shm_overflow_policy
+{
+    drop_new,     // drop the message if the ring is full
+    overwrite_old // overwrite the oldest messages not read yet
+};
+
+enum class shm_record_format
+{
+    text,  // the logger's formatted text
+    binary // the compact binary format (see binary_formatter.h), formatted by the reader
+};
+
+/*
+ * Sink writing the messages to a ring buffer in POSIX shared memory (see details/shm_ring.h), to be drained by
+ * another process writing the files (see the spdlog-shm-reader example). Logging costs a copy to memory: no system
+ * call, and never waits for the reader. If the reader does not keep up, messages are dropped or overwritten
+ * according to the overflow policy, and counted in dropped().
+ *
+ * Binary records share their string table (format strings, logger names) with the previous records of their
+ * generation, i.e. the records written since the ring last wrapped, so a format string or a logger name is written
+ * once per generation instead of once per record. A dropped record ends its generation. Read the binary records in
+ * order with shm_ring_binary_reader, which skips the records of a generation once one of them was lost.
+ * With binary records, set the logger's pattern to "" to skip text formatting.
+ */
+template<class Mutex>
+class shm_ring_sink SPDLOG_FINAL : public base_sink<Mutex>
+{
+public:
+    explicit shm_ring_sink(const std::string &shm_name, size_t capacity = 16 * 1024 * 1024,
+        shm_overflow_policy overflow_policy = shm_overflow_policy::drop_new, shm_record_format format = shm_record_format::text)
+        : _ring(shm_name, capacity)
+        , _overwrite(overflow_policy == shm_overflow_policy::overwrite_old)
+        , _format(format)
+    {
+    }
+
+    // messages dropped or overwritten before being read (by all the writers of the ring since it was created)
+    uint64_t dropped()
+    {
+        return _ring.dropped();
+    }
+
+    unsigned capture_flags() const override
+    {
+        return _format == shm_record_format::binary ? capture::all : capture::none;
+    }
+
+protected:
+    void _sink_it(const details::log_msg &msg) override
+    {
+        if (_format == shm_record_format::text)
+        {
+            _ring.write(details::shm_ring::text, msg.formatted.data(), msg.formatted.size(), _overwrite);
+            return;
+        }
+        auto position = _ring.write_position();
+        if (!_generation_valid || position / _ring.capacity() != _generation / _ring.capacity())
+        {
+            // the ring wrapped, or the previous record was dropped: restart the string table
+            _binary_formatter.reset();
+            _generation = position;
+            _generation_index = 0;
+        }
+        // each record starts with its generation and its index in the generation (see shm_ring_binary_reader)
+        _buffer.clear();
+        details::binary::write_varint(_buffer, _generation);
+        details::binary::write_varint(_buffer, _generation_index++);
+        _binary_formatter.format(msg, _buffer);
+        _generation_valid = _ring.write(details::shm_ring::binary, _buffer.data(), _buffer.size(), _overwrite);
+    }
+
+    void _flush() override {}
+
+private:
+    details::shm_ring _ring;
+    const bool _overwrite;
+    const shm_record_format _format;
+    binary_formatter _binary_formatter;
+    fmt::MemoryWriter _buffer;
+    // position in the ring of the first record of the current generation, and index of the next record in it
+    uint64_t _generation{0};
+    uint64_t _generation_index{0};
+    bool _generation_valid{false};
+};
+
+/*
+ * Decoder of the binary records of a shm_ring_sink, read in order from the ring.
+ * A record is decoded only if all the records of its generation before it were: a record whose string definitions
+ * were dropped or overwritten before being read is skipped, as are the next ones until a new generation starts.
+ */
+class shm_ring_binary_reader
+{
+public:
+    // pass each message of the record to fun(details::log_msg &). return false if the record was skipped.
+    // throw spdlog_ex if the record is corrupted.
+    template<class Fun>
+    bool read(const char *data, size_t size, Fun fun)
+    {
+        const char *pos = data;
+        details::binary::input in(pos, data + size);
+        auto generation = in.read_varint();
+        auto index = in.read_varint();
+        if (index != 0 && (!_valid || generation != _generation || index != _next_index))
+        {
+            _valid = false;
+            return false;
+        }
+        _generation = generation;
+        _next_index = index + 1;
+        _valid = false; // until the record is fully decoded
+        _reader.set_input(pos, static_cast<size_t>(data + size - pos));
+        details::log_msg msg;
+        while (_reader.next(msg))
+        {
+            fun(msg);
+        }
+        _valid = true;
+        return true;
+    }
+
+private:
+    binary_reader _reader;
+    uint64_t _generation{0};
+    uint64_t _next_index{0};
+    bool _valid{false};
+};
+
+using shm_ring_sink_mt = shm_ring_sink<std::mutex>;
+using shm_ring_sink_st = shm_ring_sink<details::null_mutex>;
+
+} // namespace sinks
+} // namespace spdlog
+
+#endif // _WIN32
@@ -7,6 +7,9 @@
 
 #include "../details/log_msg.h"
 
+#include <atomic>
+#include <cstdint>
+
 namespace spdlog {
 namespace sinks {
 class sink
@@ -21,6 +24,19 @@ public:
     void set_level(level::level_enum log_level);
     level::level_enum level() const;
 
+    // incremented whenever the level of any sink changes, so dispatch tables know when to rebuild
+    // (see details/sink_dispatch.h)
+    static std::atomic<uint64_t> &levels_version();
+
+    // log_msg fields (see capture::flags) this sink reads directly, in addition to the formatted text.
+    // all of them by default: sinks using only msg.formatted override it so loggers can skip capturing the others.
+    virtual unsigned capture_flags() const;
+
+    // called by the loggers using this sink with their formatter, on construction and when it changes.
+    // the messages passed to log() are already formatted: override only if the sink logs messages of its own,
+    // so they get the same layout as the others.
+    virtual void set_formatter(formatter_ptr msg_formatter);
+
 private:
     level_t _level{level::trace};
 };
@@ -33,8 +49,22 @@ inline bool sink::should_log(level::level_enum msg_level) const
 inline void sink::set_level(level::level_enum log_level)
 {
     _level.store(log_level);
+    levels_version().fetch_add(1, std::memory_order_acq_rel);
 }
 
+inline std::atomic<uint64_t> &sink::levels_version()
+{
+    static std::atomic<uint64_t> s_version{1};
+    return s_version;
+}
+
+inline unsigned sink::capture_flags() const
+{
+    return capture::all;
+}
+
+inline void sink::set_formatter(formatter_ptr) {}
+
 inline level::level_enum sink::level() const
 {
     return static_cast<spdlog::level::level_enum>(_level.load(std::memory_order_relaxed));
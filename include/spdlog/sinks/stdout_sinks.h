@@ -7,6 +7,7 @@
 
 #include "../details/null_mutex.h"
 #include "base_sink.h"
+#include "flush_policy.h"
 
 #include <cstdio>
 #include <memory>
@@ -21,7 +22,15 @@ class stdout_sink SPDLOG_FINAL : public base_sink<Mutex>
     using MyType = stdout_sink<Mutex>;
 
 public:
-    explicit stdout_sink() = default;
+    explicit stdout_sink(const flush_policy &policy = flush_policy::every_message())
+        : _flush_tracker(policy)
+    {
+    }
+
+    ~stdout_sink() override
+    {
+        fflush(stdout);
+    }
 
     static std::shared_ptr<MyType> instance()
     {
@@ -29,17 +38,35 @@ public:
         return instance;
     }
 
+    void set_flush_policy(const flush_policy &policy)
+    {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::_mutex);
+        _flush_tracker.set_policy(policy);
+    }
+
+    unsigned capture_flags() const override
+    {
+        return capture::none;
+    }
+
 protected:
     void _sink_it(const details::log_msg &msg) override
     {
         fwrite(msg.formatted.data(), sizeof(char), msg.formatted.size(), stdout);
-        _flush();
+        if (_flush_tracker.should_flush(msg.level, msg.formatted.size()))
+        {
+            _flush();
+        }
     }
 
     void _flush() override
     {
         fflush(stdout);
+        _flush_tracker.flushed();
     }
+
+private:
+    details::flush_tracker _flush_tracker;
 };
 
 using stdout_sink_mt = stdout_sink<std::mutex>;
@@ -51,7 +78,15 @@ class stderr_sink SPDLOG_FINAL : public base_sink<Mutex>
     using MyType = stderr_sink<Mutex>;
 
 public:
-    explicit stderr_sink() = default;
+    explicit stderr_sink(const flush_policy &policy = flush_policy::every_message())
+        : _flush_tracker(policy)
+    {
+    }
+
+    ~stderr_sink() override
+    {
+        fflush(stderr);
+    }
 
     static std::shared_ptr<MyType> instance()
     {
@@ -59,17 +94,35 @@ public:
         return instance;
     }
 
+    void set_flush_policy(const flush_policy &policy)
+    {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::_mutex);
+        _flush_tracker.set_policy(policy);
+    }
+
+    unsigned capture_flags() const override
+    {
+        return capture::none;
+    }
+
 protected:
     void _sink_it(const details::log_msg &msg) override
     {
         fwrite(msg.formatted.data(), sizeof(char), msg.formatted.size(), stderr);
-        _flush();
+        if (_flush_tracker.should_flush(msg.level, msg.formatted.size()))
+        {
+            _flush();
+        }
     }
 
     void _flush() override
     {
         fflush(stderr);
+        _flush_tracker.flushed();
     }
+
+private:
+    details::flush_tracker _flush_tracker;
 };
 
 using stderr_sink_mt = stderr_sink<std::mutex>;
@@ -57,6 +57,11 @@ public:
 
     void flush() override {}
 
+    unsigned capture_flags() const override
+    {
+        return capture::raw;
+    }
+
 private:
     std::array<int, 7> _priorities;
     // must store the ident because the man says openlog might use the pointer as is and not a string copy
@@ -0,0 +1,296 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+#pragma once
+
+#ifndef _WIN32
+
+#include "../common.h"
+#include "../details/log_msg.h"
+#include "../details/net.h"
+#include "../details/null_mutex.h"
+#include "../details/os.h"
+#include "base_sink.h"
+#include "flush_policy.h"
+
+#include <cerrno>
+#include <chrono>
+#include <mutex>
+#include <string>
+
+#include <poll.h>
+
+namespace spdlog {
+namespace sinks {
+
+/**
+ * Sink that writes the formatted messages to a persistent TCP connection to host:port (e.g. a local log aggregator).
+ *
+ * Logging never blocks on the network. Messages are appended to a write buffer, which is written to the socket
+ * according to the flush_policy (after each message by default). What the socket does not take right away stays
+ * in the buffer for the next write.
+ *
+ * The host is resolved once, by the constructor, which throws spdlog_ex if it cannot be resolved: reconnecting
+ * never waits for a name lookup.
+ * The connection is made without blocking. If it fails or is lost, the sink reconnects on a later message, waiting
+ * an exponentially growing delay between attempts (see set_reconnect_backoff()). Meanwhile messages are kept in the
+ * buffer, up to max_buffer_size bytes. Messages which do not fit are dropped and counted in dropped().
+ * A message partly written when the connection was lost is not resent.
+ *
+ * flush() writes what the socket takes without blocking. The destructor waits up to a second for the rest.
+ */
+template<class Mutex>
+class tcp_sink : public base_sink<Mutex>
+{
+public:
+    static const size_t default_max_buffer_size = 4 * 1024 * 1024;
+
+    tcp_sink(const std::string &host, int port, const flush_policy &policy = flush_policy::every_message(),
+        size_t max_buffer_size = default_max_buffer_size)
+        : _flush_tracker(policy)
+        , _max_buffer_size(max_buffer_size)
+    {
+        if (!details::net::resolve(host, port, SOCK_STREAM, _address))
+        {
+            throw spdlog_ex("Failed resolving " + host + ":" + std::to_string(port));
+        }
+        _connect();
+    }
+
+    ~tcp_sink() override
+    {
+        _drain(std::chrono::seconds(1));
+        details::net::close_socket(_fd);
+    }
+
+    void set_flush_policy(const flush_policy &policy)
+    {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::_mutex);
+        _flush_tracker.set_policy(policy);
+    }
+
+    // delay before the first reconnection attempt, doubled after each failed attempt up to max_delay
+    void set_reconnect_backoff(std::chrono::milliseconds min_delay, std::chrono::milliseconds max_delay)
+    {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::_mutex);
+        _min_backoff = std::chrono::duration_cast<std::chrono::nanoseconds>(min_delay).count();
+        _max_backoff = std::chrono::duration_cast<std::chrono::nanoseconds>(max_delay).count();
+        _backoff = _min_backoff;
+        if (_state == state::disconnected)
+        {
+            _next_attempt = details::os::coarse_steady_nanos() + _backoff;
+        }
+    }
+
+    // number of messages dropped because the buffer was full
+    size_t dropped()
+    {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::_mutex);
+        return _dropped;
+    }
+
+    bool connected()
+    {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::_mutex);
+        return _state == state::connected;
+    }
+
+    unsigned capture_flags() const override
+    {
+        return capture::none;
+    }
+
+protected:
+    void _sink_it(const details::log_msg &msg) override
+    {
+        if (_pending() + msg.formatted.size() > _max_buffer_size)
+        {
+            _write();
+            if (_pending() + msg.formatted.size() > _max_buffer_size)
+            {
+                ++_dropped;
+                return;
+            }
+        }
+        _buffer.append(msg.formatted.data(), msg.formatted.size());
+        if (_flush_tracker.should_flush(msg.level, msg.formatted.size()))
+        {
+            _flush();
+        }
+    }
+
+    void _flush() override
+    {
+        _write();
+        _flush_tracker.flushed();
+    }
+
+private:
+    enum class state
+    {
+        disconnected,
+        connecting,
+        connected
+    };
+
+    size_t _pending() const
+    {
+        return _buffer.size() - _sent;
+    }
+
+    // write what the socket takes without blocking, connecting first if needed
+    void _write()
+    {
+        if (!_progress_connection())
+        {
+            return;
+        }
+        while (_pending() > 0)
+        {
+            auto n = ::send(_fd, _buffer.data() + _sent, _pending(), details::net::send_flags);
+            if (n > 0)
+            {
+                _sent += static_cast<size_t>(n);
+                continue;
+            }
+            if (n == -1 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            {
+                break;
+            }
+            _disconnect();
+            break;
+        }
+        if (_sent == _buffer.size())
+        {
+            _buffer.clear();
+            _sent = 0;
+        }
+        else if (_sent > _buffer.size() / 2)
+        {
+            _buffer.erase(0, _sent);
+            _sent = 0;
+        }
+    }
+
+    // start or complete the connection if needed. return true if connected.
+    bool _progress_connection()
+    {
+        if (_state == state::disconnected)
+        {
+            if (details::os::coarse_steady_nanos() < _next_attempt)
+            {
+                return false;
+            }
+            _connect();
+        }
+        if (_state == state::connecting)
+        {
+            struct pollfd pfd;
+            pfd.fd = _fd;
+            pfd.events = POLLOUT;
+            pfd.revents = 0;
+            auto ready = ::poll(&pfd, 1, 0);
+            if (ready == 0)
+            {
+                return false; // in progress
+            }
+            int err = 0;
+            socklen_t len = sizeof(err);
+            if (ready < 0 || ::getsockopt(_fd, SOL_SOCKET, SO_ERROR, &err, &len) != 0 || err != 0)
+            {
+                _disconnect();
+                return false;
+            }
+            // messages are batched by the write buffer, don't delay them further
+            int on = 1;
+            ::setsockopt(_fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+            _state = state::connected;
+            _backoff = _min_backoff;
+        }
+        return _state == state::connected;
+    }
+
+    void _connect()
+    {
+        _fd = details::net::connect_nonblocking(_address, SOCK_STREAM);
+        if (_fd == -1)
+        {
+            _schedule_reconnect();
+            return;
+        }
+        _state = state::connecting;
+    }
+
+    void _disconnect()
+    {
+        details::net::close_socket(_fd);
+        _state = state::disconnected;
+        if (_sent > 0 && _buffer[_sent - 1] != '\n')
+        {
+            // skip the rest of the message partly written, the receiver got it truncated
+            auto eol = _buffer.find('\n', _sent);
+            _sent = eol == std::string::npos ? _buffer.size() : eol + 1;
+        }
+        _schedule_reconnect();
+    }
+
+    void _schedule_reconnect()
+    {
+        _state = state::disconnected;
+        _next_attempt = details::os::coarse_steady_nanos() + _backoff;
+        _backoff = _backoff < _max_backoff / 2 ? _backoff * 2 : _max_backoff;
+    }
+
+    // wait up to the given time for the buffer to be written
+    void _drain(std::chrono::milliseconds timeout)
+    {
+        auto deadline = details::os::coarse_steady_nanos() + std::chrono::duration_cast<std::chrono::nanoseconds>(timeout).count();
+        for (;;)
+        {
+            _write();
+            auto now = details::os::coarse_steady_nanos();
+            if (_pending() == 0 || _state == state::disconnected || now >= deadline)
+            {
+                return;
+            }
+            struct pollfd pfd;
+            pfd.fd = _fd;
+            pfd.events = POLLOUT;
+            pfd.revents = 0;
+            ::poll(&pfd, 1, static_cast<int>((deadline - now) / 1000000 + 1));
+        }
+    }
+
+    details::net::address _address;
+    details::flush_tracker _flush_tracker;
+    const size_t _max_buffer_size;
+
+    int _fd{-1};
+    state _state{state::disconnected};
+    int64_t _min_backoff{100 * 1000000LL};
+    int64_t _max_backoff{30 * 1000000000LL};
+    int64_t _backoff{_min_backoff};
+    int64_t _next_attempt{0};
+
+    // messages not written yet start at _sent
+    std::string _buffer;
+    size_t _sent{0};
+    size_t _dropped{0};
+};
+
+template<class Mutex>
+const size_t tcp_sink<Mutex>::default_max_buffer_size;
+
+using tcp_sink_mt = tcp_sink<std::mutex>;
+using tcp_sink_st = tcp_sink<details::null_mutex>;
+
+} // namespace sinks
+} // namespace spdlog
+
+#endif // _WIN32
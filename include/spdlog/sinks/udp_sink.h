@@ -0,0 +1,144 @@
+//
+// Copyright(c) 2018 spdlog authors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+#pragma once
+
+#ifndef _WIN32
+
+#include "../common.h"
+#include "../details/datagram_batch.h"
+#include "../details/log_msg.h"
+#include "../details/net.h"
+#include "../details/null_mutex.h"
+#include "base_sink.h"
+#include "flush_policy.h"
+
+#include <cerrno>
+#include <mutex>
+#include <string>
+
+namespace spdlog {
+namespace sinks {
+
+/**
+ * Sink that sends each formatted message as a UDP datagram to host:port (e.g. a local log aggregator).
+ *
+ * The socket is non blocking: messages which cannot be sent right away (EAGAIN) are dropped and counted in
+ * dropped(). When the host refuses a datagram (nothing listening on the port), the error is reported by the next
+ * send instead, which is then retried once.
+ *
+ * Messages are sent according to the flush_policy: after each message by default, or batched and sent together
+ * (with a single sendmmsg() call on Linux) when the policy triggers, the batch is full or on flush().
+ */
+template<class Mutex>
+class udp_sink : public base_sink<Mutex>
+{
+public:
+    // messages kept in a batch before it is sent regardless of the flush policy
+    static const size_t max_batch = details::datagram_batch::max_datagrams;
+
+    udp_sink(const std::string &host, int port, const flush_policy &policy = flush_policy::every_message())
+        : _flush_tracker(policy)
+    {
+        details::net::address addr;
+        if (!details::net::resolve(host, port, SOCK_DGRAM, addr))
+        {
+            throw spdlog_ex("Failed resolving " + host + ":" + std::to_string(port));
+        }
+        _fd = details::net::connect_nonblocking(addr, SOCK_DGRAM);
+        if (_fd == -1)
+        {
+            throw spdlog_ex("Failed creating udp socket to " + host + ":" + std::to_string(port), errno);
+        }
+    }
+
+    ~udp_sink() override
+    {
+        _send_batch();
+        details::net::close_socket(_fd);
+    }
+
+    void set_flush_policy(const flush_policy &policy)
+    {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::_mutex);
+        _flush_tracker.set_policy(policy);
+    }
+
+    // number of messages dropped because the socket was busy or could not send them
+    size_t dropped()
+    {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::_mutex);
+        return _dropped;
+    }
+
+    unsigned capture_flags() const override
+    {
+        return capture::none;
+    }
+
+protected:
+    void _sink_it(const details::log_msg &msg) override
+    {
+        _batch.start();
+        _batch.writer() << fmt::StringRef(msg.formatted.data(), msg.formatted.size());
+        auto size = _batch.finish();
+        if (_batch.full() || _flush_tracker.should_flush(msg.level, size))
+        {
+            _flush();
+        }
+    }
+
+    void _flush() override
+    {
+        _send_batch();
+        _flush_tracker.flushed();
+    }
+
+private:
+    void _send_batch()
+    {
+        // pending datagrams when the first one was retried after a refusal, 0 if none was
+        size_t retried = 0;
+        while (!_batch.send(_fd))
+        {
+            auto err = errno;
+            if (err == EINTR)
+            {
+                continue;
+            }
+            if (err == EAGAIN || err == EWOULDBLOCK)
+            {
+                break;
+            }
+            if (err == ECONNREFUSED && _batch.pending() != retried)
+            {
+                // the refusal of an earlier datagram: this one was not sent, retry it once
+                retried = _batch.pending();
+                continue;
+            }
+            // refused again, too large...: skip it
+            _batch.drop_first();
+            ++_dropped;
+        }
+        _dropped += _batch.pending();
+        _batch.clear();
+    }
+
+    int _fd{-1};
+    details::flush_tracker _flush_tracker;
+    details::datagram_batch _batch;
+    size_t _dropped{0};
+};
+
+template<class Mutex>
+const size_t udp_sink<Mutex>::max_batch;
+
+using udp_sink_mt = udp_sink<std::mutex>;
+using udp_sink_st = udp_sink<details::null_mutex>;
+
+} // namespace sinks
+} // namespace spdlog
+
+#endif // _WIN32
@@ -57,6 +57,11 @@ public:
         colors_[level] = color;
     }
 
+    unsigned capture_flags() const override
+    {
+        return capture::none;
+    }
+
 protected:
     void _sink_it(const details::log_msg &msg) override
     {
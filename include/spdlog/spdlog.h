@@ -8,21 +8,34 @@
 #pragma once
 
 #include "common.h"
+#include "details/log_site.h"
 #include "logger.h"
 
 #include <chrono>
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace spdlog {
 
+class logger_handle;
+
 //
-// Return an existing logger or nullptr if a logger with such name doesn't exist.
+// Return an existing logger or nullptr if a logger with such name doesn't exist. Lock free.
 // example: spdlog::get("my_logger")->info("hello {}", "world");
 //
 std::shared_ptr<logger> get(const std::string &name);
 
+//
+// Return a handle to the logger registered under the given name, now or later.
+// Resolving the handle is cheaper than get(): no hashing of the name and no locking.
+// example:
+// static auto net_log = spdlog::get_handle("net");
+// net_log->info("hello {}", "world");
+//
+logger_handle get_handle(const std::string &name);
+
 //
 // Set global formatting
 // example: spdlog::set_pattern("%Y-%m-%d %H:%M:%S.%e %l : %v");
@@ -40,6 +53,55 @@ void set_level(level::level_enum log_level);
 //
 void flush_on(level::level_enum log_level);
 
+//
+// Hierarchical configuration by dotted logger names:
+// "net.http.client" is below "net.http", which is below "net". The root is "".
+// The level and flush level set on a name apply to the loggers at and below it, now and registered later,
+// except below names which set their own. The global set_level() and flush_on() set the root and override the rest.
+// example: spdlog::set_level("net", spdlog::level::debug);
+//
+void set_level(const std::string &logger_name, level::level_enum log_level);
+void flush_on(const std::string &logger_name, level::level_enum log_level);
+
+//
+// Set the levels given as a spec of comma separated entries, at once.
+// "name=level" sets the level of a logger and the loggers below it, a level without a name sets the global level.
+// Level names are those printed by %l, "warn" and "err". Throws spdlog_ex if the spec is malformed.
+// example: spdlog::set_levels("info,net=debug,net.http.client=trace");
+//
+void set_levels(const std::string &spec);
+
+//
+// Set the levels from the given environment variable, if defined. Typically called once at startup.
+// example: SPDLOG_LEVEL=info,net=debug ./my_app
+//
+void load_env_levels(const char *env_var = "SPDLOG_LEVEL");
+
+//
+// Set the levels from a control file, now and each time its content changes, from a background thread.
+// The file holds a level spec as above, one or more entries per line, with '#' comments. Watching another file
+// replaces the previous one. Set the global level in the file to reset the levels of removed entries.
+// example:
+// spdlog::watch_level_file("/etc/my_app/log_levels");
+// $ echo "info,net=debug" > /etc/my_app/log_levels
+//
+void watch_level_file(const filename_t &filename);
+void stop_watching_level_file();
+
+//
+// Set the sinks of the loggers get_or_create() creates at or below the given name.
+// example: spdlog::set_sinks("", {console_sink}); spdlog::set_sinks("net", {console_sink, net_file_sink});
+//
+void set_sinks(const std::string &logger_name, std::vector<sink_ptr> sinks);
+
+//
+// Return the logger with the given name, creating and registering it if it doesn't exist.
+// A new logger uses the sinks of its nearest ancestor which has any (set by set_sinks() or used by its logger),
+// and the levels set on its ancestors.
+// example: spdlog::get_or_create("net.http.client")->debug("connecting");
+//
+std::shared_ptr<logger> get_or_create(const std::string &logger_name);
+
 //
 // Set global error handler
 //
@@ -76,6 +138,14 @@ void set_sync_mode();
 std::shared_ptr<logger> basic_logger_mt(const std::string &logger_name, const filename_t &filename, bool truncate = false);
 std::shared_ptr<logger> basic_logger_st(const std::string &logger_name, const filename_t &filename, bool truncate = false);
 
+//
+// Create and register multi/single threaded binary file logger.
+// Messages are stored in the compact binary format (see binary_formatter.h) and can be
+// rendered back to text with the spdlog-decode example tool.
+//
+std::shared_ptr<logger> binary_logger_mt(const std::string &logger_name, const filename_t &filename, bool truncate = false);
+std::shared_ptr<logger> binary_logger_st(const std::string &logger_name, const filename_t &filename, bool truncate = false);
+
 //
 // Create and register multi/single threaded rotating file logger
 //
@@ -154,7 +224,8 @@ std::shared_ptr<logger> create_async(const std::string &logger_name, const It &s
     const std::chrono::milliseconds &flush_interval_ms = std::chrono::milliseconds::zero(),
     const std::function<void()> &worker_teardown_cb = nullptr);
 
-// Register the given logger with the given name
+// Register the given logger with the given name.
+// The logger keeps the levels it has: only the levels set afterwards for its name or above apply to it.
 void register_logger(std::shared_ptr<logger> logger);
 
 // Apply a user defined function on all registered loggers
@@ -168,35 +239,145 @@ void drop(const std::string &name);
 // Drop all references from the registry
 void drop_all();
 
+// Enable or disable the SPDLOG_<LEVEL> macro call sites at runtime, regardless of the loggers' levels.
+// Sites are selected by glob ('*' and '?') on their file (full path or base name), function or logger name.
+// The rules also apply to sites executed for the first time later on. Later rules take precedence.
+// Example: spdlog::set_log_sites_by_function("handle_request", spdlog::log_site_state::enabled);
+void set_log_sites_by_file(const std::string &file_glob, log_site_state state);
+void set_log_sites_by_function(const std::string &function_glob, log_site_state state);
+void set_log_sites_by_logger(const std::string &logger_glob, log_site_state state);
+
+// Drop all the rules above. All sites follow their logger's level again.
+void reset_log_sites();
+
 ///////////////////////////////////////////////////////////////////////////////
 //
-// Trace & Debug can be switched on/off at compile time for zero cost debug statements.
-// Uncomment SPDLOG_DEBUG_ON/SPDLOG_TRACE_ON in tweakme.h to enable.
-// SPDLOG_TRACE(..) will also print current file and line.
+// Compile time log level floor for zero cost log statements.
+// Calls below SPDLOG_ACTIVE_LEVEL (see tweakme.h) expand to nothing.
+// Calls above it check the logger's level before evaluating any of their arguments.
+// The macros also pass the source location of the call, printed by the %s (file), %# (line) and %! (function) flags.
 //
 // Example:
+// #define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE // before including spdlog.h
 // spdlog::set_level(spdlog::level::trace);
+// spdlog::set_pattern("[%l] [%s:%#] %v");
 // SPDLOG_TRACE(my_logger, "some trace message");
 // SPDLOG_TRACE(my_logger, "another trace message {} {}", 1, 2);
 // SPDLOG_DEBUG(my_logger, "some debug message {} {}", 3, 4);
+// SPDLOG_INFO(my_logger, "expensive {}", compute()); // compute() is not called if info is disabled
+//
+// Each call site can also be enabled or disabled at runtime, regardless of the logger's level:
+// spdlog::set_log_sites_by_file("*/net/*.cpp", spdlog::log_site_state::enabled);
+//
+// Rate limited variants, with lock free state per call site. Suppressed calls are not formatted,
+// and the next call let through also logs how many calls were suppressed:
+// SPDLOG_WARN_EVERY_N(my_logger, 1000, "queue full {}", n);                         // 1st, 1001st, ...
+// SPDLOG_WARN_EVERY(my_logger, std::chrono::seconds(1), "queue full {}", n);        // at most once per second
+// SPDLOG_WARN_SAMPLED(my_logger, 0.01, "queue full {}", n);                         // 1% of the calls
 ///////////////////////////////////////////////////////////////////////////////
 
-#ifdef SPDLOG_TRACE_ON
-#define SPDLOG_STR_H(x) #x
-#define SPDLOG_STR_HELPER(x) SPDLOG_STR_H(x)
-#ifdef _MSC_VER
-#define SPDLOG_TRACE(logger, ...) logger->trace("[ " __FILE__ "(" SPDLOG_STR_HELPER(__LINE__) ") ] " __VA_ARGS__)
-#else
-#define SPDLOG_TRACE(logger, ...) logger->trace("[ " __FILE__ ":" SPDLOG_STR_HELPER(__LINE__) " ] " __VA_ARGS__)
-#endif
+#define SPDLOG_LOGGER_CALL(logger, level, ...)                                                                                             \
+    do                                                                                                                                     \
+    {                                                                                                                                      \
+        static spdlog::details::log_site spdlog_log_site_{__FILE__, __LINE__, SPDLOG_FUNCTION, level};                                     \
+        auto &&spdlog_logger_ = (logger);                                                                                                  \
+        if (spdlog_log_site_.should_log(*spdlog_logger_))                                                                                  \
+        {                                                                                                                                  \
+            spdlog_logger_->force_log(spdlog_log_site_.loc, level, __VA_ARGS__);                                                           \
+        }                                                                                                                                  \
+        else if (spdlog_logger_->should_backtrace())                                                                                       \
+        {                                                                                                                                  \
+            spdlog_logger_->push_backtrace(spdlog_log_site_.loc, level, __VA_ARGS__);                                                      \
+        }                                                                                                                                  \
+    } while (0)
+
+#define SPDLOG_LOGGER_LIMITED_CALL(logger, level, allow, ...)                                                                              \
+    do                                                                                                                                     \
+    {                                                                                                                                      \
+        static spdlog::details::log_site spdlog_log_site_{__FILE__, __LINE__, SPDLOG_FUNCTION, level};                                     \
+        static spdlog::details::log_limiter spdlog_log_limiter_;                                                                           \
+        auto &&spdlog_logger_ = (logger);                                                                                                  \
+        if (spdlog_log_site_.should_log(*spdlog_logger_) && spdlog_log_limiter_.allow)                                                     \
+        {                                                                                                                                  \
+            spdlog_logger_->force_log(spdlog_log_site_.loc, level, __VA_ARGS__);                                                           \
+            spdlog::details::report_suppressed(*spdlog_logger_, spdlog_log_site_.loc, level, spdlog_log_limiter_);                         \
+        }                                                                                                                                  \
+    } while (0)
+
+#define SPDLOG_LOGGER_EVERY_N(logger, level, n, ...) SPDLOG_LOGGER_LIMITED_CALL(logger, level, every_n(n), __VA_ARGS__)
+#define SPDLOG_LOGGER_EVERY(logger, level, interval, ...) SPDLOG_LOGGER_LIMITED_CALL(logger, level, every(interval), __VA_ARGS__)
+#define SPDLOG_LOGGER_SAMPLED(logger, level, ratio, ...) SPDLOG_LOGGER_LIMITED_CALL(logger, level, sampled(ratio), __VA_ARGS__)
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
+#define SPDLOG_TRACE(logger, ...) SPDLOG_LOGGER_CALL(logger, spdlog::level::trace, __VA_ARGS__)
+#define SPDLOG_TRACE_EVERY_N(logger, n, ...) SPDLOG_LOGGER_EVERY_N(logger, spdlog::level::trace, n, __VA_ARGS__)
+#define SPDLOG_TRACE_EVERY(logger, interval, ...) SPDLOG_LOGGER_EVERY(logger, spdlog::level::trace, interval, __VA_ARGS__)
+#define SPDLOG_TRACE_SAMPLED(logger, ratio, ...) SPDLOG_LOGGER_SAMPLED(logger, spdlog::level::trace, ratio, __VA_ARGS__)
 #else
 #define SPDLOG_TRACE(logger, ...) (void)0
+#define SPDLOG_TRACE_EVERY_N(logger, n, ...) (void)0
+#define SPDLOG_TRACE_EVERY(logger, interval, ...) (void)0
+#define SPDLOG_TRACE_SAMPLED(logger, ratio, ...) (void)0
 #endif
 
-#ifdef SPDLOG_DEBUG_ON
-#define SPDLOG_DEBUG(logger, ...) logger->debug(__VA_ARGS__)
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+#define SPDLOG_DEBUG(logger, ...) SPDLOG_LOGGER_CALL(logger, spdlog::level::debug, __VA_ARGS__)
+#define SPDLOG_DEBUG_EVERY_N(logger, n, ...) SPDLOG_LOGGER_EVERY_N(logger, spdlog::level::debug, n, __VA_ARGS__)
+#define SPDLOG_DEBUG_EVERY(logger, interval, ...) SPDLOG_LOGGER_EVERY(logger, spdlog::level::debug, interval, __VA_ARGS__)
+#define SPDLOG_DEBUG_SAMPLED(logger, ratio, ...) SPDLOG_LOGGER_SAMPLED(logger, spdlog::level::debug, ratio, __VA_ARGS__)
 #else
 #define SPDLOG_DEBUG(logger, ...) (void)0
+#define SPDLOG_DEBUG_EVERY_N(logger, n, ...) (void)0
+#define SPDLOG_DEBUG_EVERY(logger, interval, ...) (void)0
+#define SPDLOG_DEBUG_SAMPLED(logger, ratio, ...) (void)0
+#endif
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO
+#define SPDLOG_INFO(logger, ...) SPDLOG_LOGGER_CALL(logger, spdlog::level::info, __VA_ARGS__)
+#define SPDLOG_INFO_EVERY_N(logger, n, ...) SPDLOG_LOGGER_EVERY_N(logger, spdlog::level::info, n, __VA_ARGS__)
+#define SPDLOG_INFO_EVERY(logger, interval, ...) SPDLOG_LOGGER_EVERY(logger, spdlog::level::info, interval, __VA_ARGS__)
+#define SPDLOG_INFO_SAMPLED(logger, ratio, ...) SPDLOG_LOGGER_SAMPLED(logger, spdlog::level::info, ratio, __VA_ARGS__)
+#else
+#define SPDLOG_INFO(logger, ...) (void)0
+#define SPDLOG_INFO_EVERY_N(logger, n, ...) (void)0
+#define SPDLOG_INFO_EVERY(logger, interval, ...) (void)0
+#define SPDLOG_INFO_SAMPLED(logger, ratio, ...) (void)0
+#endif
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_WARN
+#define SPDLOG_WARN(logger, ...) SPDLOG_LOGGER_CALL(logger, spdlog::level::warn, __VA_ARGS__)
+#define SPDLOG_WARN_EVERY_N(logger, n, ...) SPDLOG_LOGGER_EVERY_N(logger, spdlog::level::warn, n, __VA_ARGS__)
+#define SPDLOG_WARN_EVERY(logger, interval, ...) SPDLOG_LOGGER_EVERY(logger, spdlog::level::warn, interval, __VA_ARGS__)
+#define SPDLOG_WARN_SAMPLED(logger, ratio, ...) SPDLOG_LOGGER_SAMPLED(logger, spdlog::level::warn, ratio, __VA_ARGS__)
+#else
+#define SPDLOG_WARN(logger, ...) (void)0
+#define SPDLOG_WARN_EVERY_N(logger, n, ...) (void)0
+#define SPDLOG_WARN_EVERY(logger, interval, ...) (void)0
+#define SPDLOG_WARN_SAMPLED(logger, ratio, ...) (void)0
+#endif
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_ERROR
+#define SPDLOG_ERROR(logger, ...) SPDLOG_LOGGER_CALL(logger, spdlog::level::err, __VA_ARGS__)
+#define SPDLOG_ERROR_EVERY_N(logger, n, ...) SPDLOG_LOGGER_EVERY_N(logger, spdlog::level::err, n, __VA_ARGS__)
+#define SPDLOG_ERROR_EVERY(logger, interval, ...) SPDLOG_LOGGER_EVERY(logger, spdlog::level::err, interval, __VA_ARGS__)
+#define SPDLOG_ERROR_SAMPLED(logger, ratio, ...) SPDLOG_LOGGER_SAMPLED(logger, spdlog::level::err, ratio, __VA_ARGS__)
+#else
+#define SPDLOG_ERROR(logger, ...) (void)0
+#define SPDLOG_ERROR_EVERY_N(logger, n, ...) (void)0
+#define SPDLOG_ERROR_EVERY(logger, interval, ...) (void)0
+#define SPDLOG_ERROR_SAMPLED(logger, ratio, ...) (void)0
+#endif
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_CRITICAL
+#define SPDLOG_CRITICAL(logger, ...) SPDLOG_LOGGER_CALL(logger, spdlog::level::critical, __VA_ARGS__)
+#define SPDLOG_CRITICAL_EVERY_N(logger, n, ...) SPDLOG_LOGGER_EVERY_N(logger, spdlog::level::critical, n, __VA_ARGS__)
+#define SPDLOG_CRITICAL_EVERY(logger, interval, ...) SPDLOG_LOGGER_EVERY(logger, spdlog::level::critical, interval, __VA_ARGS__)
+#define SPDLOG_CRITICAL_SAMPLED(logger, ratio, ...) SPDLOG_LOGGER_SAMPLED(logger, spdlog::level::critical, ratio, __VA_ARGS__)
+#else
+#define SPDLOG_CRITICAL(logger, ...) (void)0
+#define SPDLOG_CRITICAL_EVERY_N(logger, n, ...) (void)0
+#define SPDLOG_CRITICAL_EVERY(logger, interval, ...) (void)0
+#define SPDLOG_CRITICAL_SAMPLED(logger, ratio, ...) (void)0
 #endif
 
 } // namespace spdlog
@@ -19,9 +19,20 @@
 // #define SPDLOG_CLOCK_COARSE
 ///////////////////////////////////////////////////////////////////////////////
 
+///////////////////////////////////////////////////////////////////////////////
+// Uncomment to read the cpu timestamp counter (rdtsc) on each log call instead of the regular clock.
+// The raw ticks are converted to wall clock time on the formatting side (i.e. in the async worker thread)
+// using a calibration that is refreshed every second by a background thread.
+// Requires an invariant tsc (all modern x86 cpus). Timestamps might be off by a few micros after recalibration.
+// The first calibration takes 10ms in the background: call spdlog::details::tsc_clock::init() at startup to wait for it.
+//
+// #define SPDLOG_CLOCK_TSC
+///////////////////////////////////////////////////////////////////////////////
+
 ///////////////////////////////////////////////////////////////////////////////
 // Uncomment if date/time logging is not needed and never appear in the log pattern.
 // This will prevent spdlog from querying the clock on each log call.
+// Note: loggers already skip the clock query at runtime if their pattern has no date/time flags.
 //
 // WARNING: If the log pattern contains any date/time while this flag is on, the result is undefined.
 //          You must set new pattern(spdlog::set_pattern(..") without any date/time in it
@@ -32,6 +43,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 // Uncomment if thread id logging is not needed (i.e. no %t in the log pattern).
 // This will prevent spdlog from querying the thread id on each log call.
+// Note: loggers already skip the thread id query at runtime if their pattern has no %t.
 //
 // WARNING: If the log pattern contains thread id (i.e, %t) while this flag is on, the result is undefined.
 //
@@ -56,11 +68,20 @@
 
 ///////////////////////////////////////////////////////////////////////////////
 // Uncomment to enable the SPDLOG_DEBUG/SPDLOG_TRACE macros.
+// Same as setting SPDLOG_ACTIVE_LEVEL to SPDLOG_LEVEL_DEBUG/SPDLOG_LEVEL_TRACE.
 //
 // #define SPDLOG_DEBUG_ON
 // #define SPDLOG_TRACE_ON
 ///////////////////////////////////////////////////////////////////////////////
 
+///////////////////////////////////////////////////////////////////////////////
+// Uncomment to set the compile time log level floor (SPDLOG_LEVEL_INFO by default).
+// Calls through the SPDLOG_TRACE/DEBUG/INFO/WARN/ERROR/CRITICAL macros below this level
+// are removed entirely, including the evaluation of their arguments.
+//
+// #define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_INFO
+///////////////////////////////////////////////////////////////////////////////
+
 ///////////////////////////////////////////////////////////////////////////////
 // Uncomment to avoid locking in the registry operations (spdlog::get(), spdlog::drop() spdlog::register()).
 // Use only if your code never modifies concurrently the registry.
@@ -82,12 +103,27 @@
 // #define SPDLOG_WCHAR_FILENAMES
 ///////////////////////////////////////////////////////////////////////////////
 
+///////////////////////////////////////////////////////////////////////////////
+// Uncomment to change the function name recorded by the SPDLOG_<LEVEL> macros (printed by the %! pattern flag).
+//
+// #define SPDLOG_FUNCTION __PRETTY_FUNCTION__
+///////////////////////////////////////////////////////////////////////////////
+
 ///////////////////////////////////////////////////////////////////////////////
 // Uncomment to override default eol ("\n" or "\r\n" under Linux/Windows)
 //
 // #define SPDLOG_EOL ";-)\n"
 ///////////////////////////////////////////////////////////////////////////////
 
+///////////////////////////////////////////////////////////////////////////////
+// Uncomment to change the initial capacity (in bytes) of log_msg's own message buffers (256 by default).
+// Messages are normally written to per thread buffers which keep their capacity between calls. The inline buffers
+// are used when these are not available: without thread local storage (see SPDLOG_NO_TLS in details/os.h), when
+// logging from inside a sink, and for messages stored by sinks and worker threads.
+//
+// #define SPDLOG_MSG_INLINE_BUFFER_SIZE 256
+///////////////////////////////////////////////////////////////////////////////
+
 ///////////////////////////////////////////////////////////////////////////////
 // Uncomment to use your own copy of the fmt library instead of spdlog's copy.
 // In this case spdlog will try to include <fmt/format.h> so set your -I flag accordingly.
@@ -75,3 +75,250 @@ TEST_CASE("drop non existing"
     REQUIRE(spdlog::get(tested_logger_name));
     spdlog::drop_all();
 }
+
+TEST_CASE("logger handle"
+          "[registry]")
+{
+    spdlog::drop_all();
+    auto handle = spdlog::get_handle(tested_logger_name);
+    REQUIRE_FALSE(handle);
+
+    auto logger = spdlog::create<spdlog::sinks::null_sink_mt>(tested_logger_name);
+    REQUIRE(handle.get() == logger);
+    REQUIRE(handle->name() == tested_logger_name);
+
+    spdlog::drop(tested_logger_name);
+    REQUIRE_FALSE(handle);
+    REQUIRE_THROWS_AS(handle->info("dropped"), const spdlog::spdlog_ex &);
+
+    auto logger2 = spdlog::create<spdlog::sinks::null_sink_mt>(tested_logger_name);
+    REQUIRE(handle.get() == logger2);
+    REQUIRE(spdlog::get_handle(tested_logger_name).get() == logger2);
+    spdlog::drop_all();
+    REQUIRE_FALSE(handle);
+}
+
+TEST_CASE("dropped names are freed"
+          "[registry]")
+{
+    spdlog::drop_all();
+    auto &registry = spdlog::details::registry::instance();
+    auto entries = registry.entries();
+    for (int i = 0; i < 100; i++)
+    {
+        auto name = "connection #" + std::to_string(i);
+        spdlog::create<spdlog::sinks::null_sink_mt>(name);
+        spdlog::drop(name);
+    }
+    REQUIRE(registry.entries() == entries);
+
+    // kept while a handle refers to the name
+    auto handle = spdlog::get_handle(tested_logger_name);
+    spdlog::create<spdlog::sinks::null_sink_mt>(tested_logger_name);
+    spdlog::drop_all();
+    REQUIRE(registry.entries() == entries + 1);
+    auto logger = spdlog::create<spdlog::sinks::null_sink_mt>(tested_logger_name);
+    REQUIRE(handle.get() == logger);
+
+    handle = spdlog::logger_handle();
+    spdlog::drop_all();
+    REQUIRE(registry.entries() == entries);
+}
+
+TEST_CASE("concurrent get while registering"
+          "[registry]")
+{
+    spdlog::drop_all();
+    spdlog::create<spdlog::sinks::null_sink_mt>(tested_logger_name);
+    std::atomic<bool> done{false};
+    std::atomic<size_t> failed{0};
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; i++)
+    {
+        readers.emplace_back([&] {
+            auto handle = spdlog::get_handle(tested_logger_name);
+            while (!done)
+            {
+                auto logger = spdlog::get(tested_logger_name);
+                if (!logger || logger->name() != tested_logger_name || handle.get() == nullptr)
+                {
+                    failed++;
+                }
+                spdlog::get(tested_logger_name2); // registered and dropped concurrently
+            }
+        });
+    }
+
+    for (int i = 0; i < 200; i++)
+    {
+        spdlog::create<spdlog::sinks::null_sink_mt>(tested_logger_name2);
+        REQUIRE(spdlog::get(tested_logger_name2));
+        spdlog::drop(tested_logger_name2);
+        REQUIRE_FALSE(spdlog::get(tested_logger_name2));
+    }
+    done = true;
+    for (auto &t : readers)
+    {
+        t.join();
+    }
+    REQUIRE(failed == 0u);
+    spdlog::drop_all();
+}
+
+TEST_CASE("hierarchical levels"
+          "[registry]")
+{
+    spdlog::drop_all();
+    auto root = spdlog::create<spdlog::sinks::null_sink_mt>("tree");
+    auto a = spdlog::create<spdlog::sinks::null_sink_mt>("tree.a");
+    auto ab = spdlog::create<spdlog::sinks::null_sink_mt>("tree.a.b");
+    auto c = spdlog::create<spdlog::sinks::null_sink_mt>("tree.c");
+
+    spdlog::set_level("tree", spdlog::level::debug);
+    REQUIRE(root->level() == spdlog::level::debug);
+    REQUIRE(a->level() == spdlog::level::debug);
+    REQUIRE(ab->level() == spdlog::level::debug);
+    REQUIRE(c->level() == spdlog::level::debug);
+
+    spdlog::set_level("tree.a", spdlog::level::err);
+    spdlog::set_level("tree", spdlog::level::trace);
+    REQUIRE(root->level() == spdlog::level::trace);
+    REQUIRE(a->level() == spdlog::level::err);
+    REQUIRE(ab->level() == spdlog::level::err);
+    REQUIRE(c->level() == spdlog::level::trace);
+
+    // inherited by loggers registered later
+    auto ax = spdlog::create<spdlog::sinks::null_sink_mt>("tree.a.x");
+    REQUIRE(ax->level() == spdlog::level::err);
+
+    // the global level overrides all
+    spdlog::set_level(spdlog::level::info);
+    REQUIRE(root->level() == spdlog::level::info);
+    REQUIRE(ab->level() == spdlog::level::info);
+    REQUIRE(ax->level() == spdlog::level::info);
+    spdlog::drop_all();
+}
+
+TEST_CASE("register_logger keeps the logger's level"
+          "[registry]")
+{
+    spdlog::drop_all();
+    spdlog::set_level(spdlog::level::warn);
+    spdlog::set_level("kept", spdlog::level::err);
+    auto logger = std::make_shared<spdlog::logger>("kept.a", std::make_shared<spdlog::sinks::null_sink_st>());
+    logger->set_level(spdlog::level::debug);
+    spdlog::register_logger(logger);
+    REQUIRE(logger->level() == spdlog::level::debug);
+
+    // until a level is set above it
+    spdlog::set_level("kept", spdlog::level::critical);
+    REQUIRE(logger->level() == spdlog::level::critical);
+    spdlog::drop_all();
+    spdlog::set_level(spdlog::level::info);
+}
+
+TEST_CASE("logger tree removes the nodes of dropped loggers"
+          "[registry]")
+{
+    spdlog::details::logger_tree tree;
+    auto logger = std::make_shared<spdlog::logger>("prune.a.b", std::make_shared<spdlog::sinks::null_sink_st>());
+    tree.attach("prune.a.b", logger.get(), true);
+    REQUIRE(tree.size() == 4u);
+    tree.detach("prune.a.b");
+    REQUIRE(tree.size() == 1u);
+
+    // nodes with settings stay
+    tree.set_level("prune.a", spdlog::level::warn);
+    tree.attach("prune.a.b", logger.get(), true);
+    REQUIRE(logger->level() == spdlog::level::warn);
+    tree.detach_all();
+    REQUIRE(tree.size() == 3u);
+}
+
+TEST_CASE("get_or_create inherits sinks"
+          "[registry]")
+{
+    spdlog::drop_all();
+    std::ostringstream oss;
+    spdlog::set_sinks("sinks_tree", {std::make_shared<spdlog::sinks::ostream_sink_mt>(oss)});
+    spdlog::set_level("sinks_tree.a", spdlog::level::warn);
+
+    auto logger = spdlog::get_or_create("sinks_tree.a.b");
+    REQUIRE(spdlog::get_or_create("sinks_tree.a.b") == logger);
+    REQUIRE(spdlog::get("sinks_tree.a.b") == logger);
+    REQUIRE(logger->sinks().size() == 1);
+    REQUIRE(logger->level() == spdlog::level::warn);
+
+    logger->set_pattern("%v");
+    logger->info("not logged");
+    logger->warn("logged");
+    REQUIRE(oss.str() == std::string("logged") + spdlog::details::os::default_eol);
+
+    // a logger with its own sinks passes them on
+    auto child = spdlog::get_or_create("sinks_tree.a.b.c");
+    REQUIRE(child->sinks() == logger->sinks());
+    spdlog::drop_all();
+    spdlog::set_level(spdlog::level::info);
+}
+
+TEST_CASE("set_levels"
+          "[registry]")
+{
+    spdlog::drop_all();
+    auto a = spdlog::create<spdlog::sinks::null_sink_mt>("levels.a");
+    auto ab = spdlog::create<spdlog::sinks::null_sink_mt>("levels.a.b");
+    auto other = spdlog::create<spdlog::sinks::null_sink_mt>("other");
+
+    // the global level is applied first, wherever it is
+    spdlog::set_levels(" levels.a = debug, warn # comment\n levels.a.b=trace");
+    REQUIRE(a->level() == spdlog::level::debug);
+    REQUIRE(ab->level() == spdlog::level::trace);
+    REQUIRE(other->level() == spdlog::level::warn);
+
+    REQUIRE_THROWS_AS(spdlog::set_levels("levels.a=verbose"), const spdlog::spdlog_ex &);
+    REQUIRE_THROWS_AS(spdlog::set_levels("=info"), const spdlog::spdlog_ex &);
+    REQUIRE(a->level() == spdlog::level::debug);
+
+#ifndef _WIN32
+    ::setenv("SPDLOG_TEST_LEVEL", "info,levels.a=error", 1);
+    spdlog::load_env_levels("SPDLOG_TEST_LEVEL");
+    REQUIRE(a->level() == spdlog::level::err);
+    REQUIRE(ab->level() == spdlog::level::err);
+    REQUIRE(other->level() == spdlog::level::info);
+    ::unsetenv("SPDLOG_TEST_LEVEL");
+#endif
+    spdlog::set_level(spdlog::level::info);
+    spdlog::drop_all();
+}
+
+TEST_CASE("watch_level_file"
+          "[registry]")
+{
+    prepare_logdir();
+    spdlog::drop_all();
+    std::string filename = "logs/levels.txt";
+    {
+        std::ofstream file(filename);
+        file << "watched=debug\n";
+    }
+    auto logger = spdlog::create<spdlog::sinks::null_sink_mt>("watched.logger");
+
+    // the file is applied right away
+    spdlog::watch_level_file(filename);
+    REQUIRE(logger->level() == spdlog::level::debug);
+
+    {
+        std::ofstream file(filename);
+        file << "info\nwatched=critical\n";
+    }
+    for (int i = 0; i < 500 && logger->level() != spdlog::level::critical; i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    REQUIRE(logger->level() == spdlog::level::critical);
+
+    spdlog::stop_watching_level_file();
+    spdlog::set_level(spdlog::level::info);
+    spdlog::drop_all();
+}
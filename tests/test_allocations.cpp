@@ -0,0 +1,89 @@
+/*
+ * This content is released under the MIT License as specified in https://raw.githubusercontent.com/gabime/spdlog/master/LICENSE
+ */
+#include "includes.h"
+#include "test_sink.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+// the replacement operator new and delete below are matched. gcc cannot tell once they are inlined.
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+// count heap allocations made by the whole program
+static std::atomic<size_t> allocations_counter{0};
+
+void *operator new(std::size_t size)
+{
+    allocations_counter.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size != 0 ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+// log messages numbered [first, last). every 100th message is a multi kilobyte one.
+static void log_messages(spdlog::logger &logger, const std::string &long_str, size_t first, size_t last)
+{
+    for (size_t i = first; i < last; i++)
+    {
+        if (i % 100 == 0)
+        {
+            logger.info("request #{} dump: {}", i, long_str);
+        }
+        else
+        {
+            logger.info("Hello message #{} {} {:.2f}", i, "text", 1.5);
+        }
+    }
+}
+
+TEST_CASE("sync logger does not allocate in steady state", "[allocations]")
+{
+    auto sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    spdlog::logger logger("alloc_logger", sink);
+    logger.set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%n] [%l] [thread %t] %v");
+    std::string long_str(8 * 1024, 'x');
+
+    // warm up: let the thread's scratch buffers grow to fit the longest message
+    log_messages(logger, long_str, 100000, 100100);
+
+    auto before = allocations_counter.load();
+    log_messages(logger, long_str, 0, 1000000);
+    auto allocations = allocations_counter.load() - before;
+
+    REQUIRE(sink->msg_counter() == 1000100);
+    REQUIRE(allocations == 0);
+}
+
+TEST_CASE("scratch buffers return to their thread from another thread", "[allocations]")
+{
+    auto sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    spdlog::logger logger("alloc_logger", sink);
+    std::string long_str(8 * 1024, 'x');
+    log_messages(logger, long_str, 100000, 100100);
+
+    // a message built here and destroyed by another thread
+    std::unique_ptr<spdlog::details::log_msg> msg(new spdlog::details::log_msg());
+    msg->raw << "moved to another thread";
+    std::thread([&msg]() { msg.reset(); }).join();
+
+    auto before = allocations_counter.load();
+    log_messages(logger, long_str, 0, 1000);
+    auto allocations = allocations_counter.load() - before;
+    REQUIRE(allocations == 0);
+}
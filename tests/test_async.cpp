@@ -1,5 +1,7 @@
 #include "includes.h"
 #include "test_sink.h"
+#include "../include/spdlog/sinks/async_sink.h"
+#include "../include/spdlog/sinks/callback_sink.h"
 
 template<class T>
 std::string log_info(const T &what, spdlog::level::level_enum logger_level = spdlog::level::info)
@@ -132,3 +134,186 @@ TEST_CASE("to_file", "[async]")
     spdlog::drop("as");
     REQUIRE(count_lines("logs/async_test.log") == messages * n_threads);
 }
+
+TEST_CASE("async logger with sink threads", "[async]")
+{
+    std::ostringstream oss_all, oss_warn;
+    auto all_sink = std::make_shared<spdlog::sinks::ostream_sink_mt>(oss_all);
+    auto warn_sink = std::make_shared<spdlog::sinks::ostream_sink_mt>(oss_warn);
+    warn_sink->set_level(spdlog::level::warn);
+    auto slow_sink = std::make_shared<spdlog::sinks::test_sink_mt>();
+    slow_sink->set_delay(std::chrono::milliseconds(1));
+    size_t messages = 100;
+    {
+        spdlog::async_logger logger("as", {all_sink, warn_sink, slow_sink}, 128, spdlog::async_overflow_policy::block_retry, nullptr,
+            std::chrono::milliseconds::zero(), nullptr, 2);
+        logger.set_pattern("%v");
+        for (size_t i = 0; i < messages; i++)
+        {
+            logger.log(i % 10 == 0 ? spdlog::level::warn : spdlog::level::info, "#{}", i);
+        }
+        logger.flush();
+    }
+
+    // each sink got its messages in order, and the flush after them
+    std::string expected_all, expected_warn;
+    for (size_t i = 0; i < messages; i++)
+    {
+        auto line = fmt::format("#{}{}", i, spdlog::details::os::default_eol);
+        expected_all += line;
+        if (i % 10 == 0)
+        {
+            expected_warn += line;
+        }
+    }
+    REQUIRE(oss_all.str() == expected_all);
+    REQUIRE(oss_warn.str() == expected_warn);
+    REQUIRE(slow_sink->msg_counter() == messages);
+    REQUIRE(slow_sink->flushed_msg_counter() == messages * 2);
+}
+
+// formats as "%v", fails on the messages starting with "bad"
+class failing_formatter : public spdlog::formatter
+{
+public:
+    void format(spdlog::details::log_msg &msg) override
+    {
+        std::string raw(msg.raw.data(), msg.raw.size());
+        if (raw.compare(0, 3, "bad") == 0)
+        {
+            throw spdlog::spdlog_ex("cannot format " + raw);
+        }
+        msg.formatted << raw << spdlog::details::os::default_eol;
+    }
+};
+
+TEST_CASE("async logger with sink threads skips failing messages and duplicated sinks", "[async]")
+{
+    std::ostringstream oss;
+    auto oss_sink = std::make_shared<spdlog::sinks::ostream_sink_st>(oss);
+    auto slow_sink = std::make_shared<spdlog::sinks::test_sink_mt>();
+    slow_sink->set_delay(std::chrono::milliseconds(1));
+    size_t errors = 0;
+    {
+        spdlog::async_logger logger("as", {oss_sink, slow_sink, oss_sink}, 128, spdlog::async_overflow_policy::block_retry, nullptr,
+            std::chrono::milliseconds::zero(), nullptr, 2);
+        logger.set_formatter(std::make_shared<failing_formatter>());
+        logger.set_error_handler([&errors](const std::string &) { errors++; });
+        logger.info("first");
+        logger.info("bad message");
+        logger.info("second");
+        logger.flush();
+    }
+
+    // the sink added twice got each message twice, from one thread, and the flush after the failure went through
+    auto eol = std::string(spdlog::details::os::default_eol);
+    REQUIRE(oss.str() == "first" + eol + "first" + eol + "second" + eol + "second" + eol);
+    REQUIRE(errors == 1u);
+    REQUIRE(slow_sink->msg_counter() == 2u);
+    REQUIRE(slow_sink->flushed_msg_counter() == 4u);
+}
+
+TEST_CASE("async_sink writes in its own thread", "[async_sink]")
+{
+    auto slow_sink = std::make_shared<spdlog::sinks::test_sink_mt>();
+    slow_sink->set_delay(std::chrono::milliseconds(1));
+    auto fast_sink = std::make_shared<spdlog::sinks::test_sink_mt>();
+    auto async_slow = std::make_shared<spdlog::sinks::async_sink>(slow_sink, 128);
+    size_t messages = 100;
+    {
+        spdlog::logger logger("async_sink", {fast_sink, async_slow});
+        for (size_t i = 0; i < messages; i++)
+        {
+            logger.info("Hello message #{}", i);
+        }
+        logger.flush();
+        REQUIRE(fast_sink->msg_counter() == messages);
+        REQUIRE(async_slow->queue_size() > 0);
+    }
+    // the dtor writes the queued messages, after the flush
+    async_slow.reset();
+    REQUIRE(slow_sink->msg_counter() == messages);
+    REQUIRE(slow_sink->flushed_msg_counter() == messages * 2);
+}
+
+TEST_CASE("async_sink discard policy", "[async_sink]")
+{
+    auto slow_sink = std::make_shared<spdlog::sinks::test_sink_mt>();
+    slow_sink->set_delay(std::chrono::milliseconds(5));
+    auto async_slow = std::make_shared<spdlog::sinks::async_sink>(slow_sink, 4, spdlog::async_overflow_policy::discard_log_msg);
+    size_t messages = 100;
+    {
+        spdlog::logger logger("async_sink", async_slow);
+        for (size_t i = 0; i < messages; i++)
+        {
+            logger.info("Hello message #{}", i);
+        }
+    }
+    auto dropped = async_slow->dropped();
+    REQUIRE(dropped > 0);
+    async_slow.reset();
+    auto total = slow_sink->msg_counter() + dropped;
+    REQUIRE(total == messages);
+}
+
+TEST_CASE("async_sink never drops flush", "[async_sink]")
+{
+    auto slow_sink = std::make_shared<spdlog::sinks::test_sink_mt>();
+    slow_sink->set_delay(std::chrono::milliseconds(5));
+    auto async_slow = std::make_shared<spdlog::sinks::async_sink>(slow_sink, 4, spdlog::async_overflow_policy::discard_log_msg);
+    {
+        spdlog::logger logger("async_sink", async_slow);
+        for (int i = 0; i < 20; i++)
+        {
+            logger.info("Hello message #{}", i);
+        }
+        logger.flush();
+    }
+    async_slow.reset();
+    // flushed once by flush(), once by the dtor, each time after all the messages written
+    auto written = slow_sink->msg_counter();
+    REQUIRE(slow_sink->flushed_msg_counter() == written * 2);
+}
+
+TEST_CASE("async_sink passes the raw text and logger name", "[async_sink]")
+{
+    std::vector<std::string> received;
+    auto callback = [&received](const spdlog::sinks::callback_record *records, size_t count) {
+        for (size_t i = 0; i < count; i++)
+        {
+            auto &r = records[i];
+            received.push_back(std::string(r.logger_name.data(), r.logger_name.size()) + ": " +
+                               std::string(r.payload.data(), r.payload.size()));
+        }
+    };
+    auto cb_sink = std::make_shared<spdlog::sinks::callback_sink_mt>(callback, 1);
+    auto async = std::make_shared<spdlog::sinks::async_sink>(cb_sink);
+    {
+        spdlog::logger logger("async_sink", async);
+        logger.set_pattern("[%n] [%l] %v");
+        logger.info("Hello {}", "async");
+    }
+    // the logger is gone: its name was copied into the queue
+    async.reset();
+    REQUIRE(received.size() == 1);
+    REQUIRE(received[0] == "async_sink: Hello async");
+}
+
+TEST_CASE("async_sink passes the messages and errors", "[async_sink]")
+{
+    std::ostringstream oss;
+    auto oss_sink = std::make_shared<spdlog::sinks::ostream_sink_mt>(oss);
+    oss_sink->set_level(spdlog::level::warn);
+    auto async = std::make_shared<spdlog::sinks::async_sink>(oss_sink);
+    std::string error;
+    async->set_error_handler([&error](const std::string &msg) { error = msg; });
+    {
+        spdlog::logger logger("async_sink", async);
+        logger.set_pattern("[%n] [%l] %v");
+        logger.info("skipped by the wrapped sink's level");
+        logger.warn("Hello {}", "async");
+    }
+    async.reset();
+    REQUIRE(oss.str() == std::string("[async_sink] [warning] Hello async") + spdlog::details::os::default_eol);
+    REQUIRE(error.empty());
+}
@@ -0,0 +1,109 @@
+/*
+ * This content is released under the MIT License as specified in https://raw.githubusercontent.com/gabime/spdlog/master/LICENSE
+ */
+#include "includes.h"
+
+static std::string eol_lines(std::initializer_list<std::string> lines)
+{
+    std::string result;
+    for (auto &line : lines)
+    {
+        result += line + spdlog::details::os::default_eol;
+    }
+    return result;
+}
+
+static std::shared_ptr<spdlog::logger> make_logger(std::ostringstream &oss)
+{
+    auto logger = std::make_shared<spdlog::logger>("backtrace_logger", std::make_shared<spdlog::sinks::ostream_sink_st>(oss));
+    logger->set_pattern("[%L] %v");
+    logger->set_level(spdlog::level::info);
+    return logger;
+}
+
+TEST_CASE("backtrace is dumped before the trigger message", "[backtrace]")
+{
+    std::ostringstream oss;
+    auto logger = make_logger(oss);
+    logger->enable_backtrace(4);
+
+    logger->debug("plain {}");
+    {
+        std::string temp("temporary");
+        logger->debug("string args {} {} {}", temp, "literal", 42);
+    }
+    logger->trace("double {:.1f}", 1.25);
+    logger->info("info");
+    REQUIRE(oss.str() == eol_lines({"[I] info"}));
+
+    logger->error("failed");
+    REQUIRE(oss.str() == eol_lines({"[I] info", "[D] plain {}", "[D] string args temporary literal 42", "[T] double 1.2",
+                             "[E] failed"}));
+
+    // dumped messages are forgotten
+    oss.str("");
+    logger->error("failed again");
+    REQUIRE(oss.str() == eol_lines({"[E] failed again"}));
+}
+
+TEST_CASE("backtrace keeps the last messages", "[backtrace]")
+{
+    std::ostringstream oss;
+    auto logger = make_logger(oss);
+    logger->enable_backtrace(3, spdlog::level::warn);
+    for (int i = 0; i < 10; i++)
+    {
+        logger->debug("message #{}", i);
+    }
+    logger->warn("warning");
+    REQUIRE(oss.str() == eol_lines({"[D] message #7", "[D] message #8", "[D] message #9", "[W] warning"}));
+}
+
+TEST_CASE("backtrace dump on demand", "[backtrace]")
+{
+    std::ostringstream oss;
+    auto logger = make_logger(oss);
+    logger->dump_backtrace(); // not enabled: no-op
+    logger->enable_backtrace(8);
+
+    std::string long_arg(300, 'x');
+    logger->debug("long {}", long_arg);
+    SPDLOG_INFO(logger, "macro {}", 1);
+    logger->set_level(spdlog::level::warn);
+    SPDLOG_INFO(logger, "macro {}", 2);
+    logger->dump_backtrace();
+    auto truncated = ("[D] long " + long_arg).substr(0, 4 + spdlog::details::backtracer::slot_data_size);
+    REQUIRE(oss.str() == eol_lines({"[I] macro 1", truncated, "[I] macro 2"}));
+
+    oss.str("");
+    logger->disable_backtrace();
+    logger->debug("not kept");
+    logger->error("failed");
+    REQUIRE(oss.str() == eol_lines({"[E] failed"}));
+}
+
+#if !defined(SPDLOG_FMT_PRINTF)
+TEST_CASE("backtrace skips messages failing to format", "[backtrace]")
+{
+    std::ostringstream oss;
+    auto logger = make_logger(oss);
+    std::vector<std::string> errors;
+    logger->set_error_handler([&errors](const std::string &msg) { errors.push_back(msg); });
+    logger->enable_backtrace(4);
+
+    logger->debug("bad {:d}", "str");
+    logger->debug("good");
+    logger->error("failed");
+    REQUIRE(errors.size() == 1);
+    REQUIRE(oss.str() == eol_lines({"[D] good", "[E] failed"}));
+
+    // the slot of the bad message is reused, and dumped again
+    oss.str("");
+    for (int i = 0; i < 8; i++)
+    {
+        logger->debug("message #{}", i);
+    }
+    logger->error("failed again");
+    REQUIRE(oss.str() == eol_lines({"[D] message #4", "[D] message #5", "[D] message #6", "[D] message #7", "[E] failed again"}));
+}
+#endif
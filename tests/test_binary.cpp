@@ -0,0 +1,93 @@
+/*
+ * This content is released under the MIT License as specified in https://raw.githubusercontent.com/gabime/spdlog/master/LICENSE
+ */
+#include "includes.h"
+#include "../include/spdlog/sinks/binary_file_sink.h"
+
+#if !defined(SPDLOG_FMT_PRINTF)
+
+// decode the binary file using the given pattern
+static std::string decode_file(const std::string &filename, const std::string &pattern)
+{
+    auto data = file_contents(filename);
+    spdlog::binary_reader reader(data.data(), data.size());
+    spdlog::pattern_formatter formatter(pattern, spdlog::pattern_time_type::local, "\n");
+    spdlog::details::log_msg msg;
+    std::string result;
+    while (reader.next(msg))
+    {
+        formatter.format(msg);
+        result += msg.formatted.str();
+    }
+    return result;
+}
+
+TEST_CASE("binary round trip", "[binary]")
+{
+    prepare_logdir();
+    std::string filename = "logs/binary_log";
+    auto logger = spdlog::binary_logger_st("binary_logger", filename);
+
+    std::string str("std::string");
+    for (int i = 0; i < 3; i++)
+    {
+        logger->info("int {} uint {} ll {} ull {}", -i, 5u, -1234567890123LL, 1234567890123ULL);
+        logger->warn("bool {} char {} double {:.2f} cstr {} str {}", true, 'x', 3.14159, "literal", str);
+        logger->error("literal message with {braces}");
+        logger->info(str);
+    }
+    logger->flush();
+
+    std::string expected;
+    for (int i = 0; i < 3; i++)
+    {
+        expected += fmt::format("[binary_logger] [info] int {} uint 5 ll -1234567890123 ull 1234567890123\n", -i);
+        expected += "[binary_logger] [warning] bool true char x double 3.14 cstr literal str std::string\n";
+        expected += "[binary_logger] [error] literal message with {braces}\n";
+        expected += "[binary_logger] [info] std::string\n";
+    }
+    REQUIRE(decode_file(filename, "[%n] [%l] %v") == expected);
+}
+
+TEST_CASE("binary format strings written once", "[binary]")
+{
+    prepare_logdir();
+    std::string filename = "logs/binary_log";
+    auto logger = spdlog::binary_logger_st("binary_logger", filename);
+    const size_t messages = 100;
+    for (size_t i = 0; i < messages; i++)
+    {
+        logger->info("This is a rather long format string that should appear in the file only once #{}", i);
+    }
+    logger->flush();
+
+    auto contents = file_contents(filename);
+    REQUIRE(contents.find("rather long format string") == contents.rfind("rather long format string"));
+    // each record is a few bytes (time delta, level, thread id, ids and the packed arg)
+    REQUIRE(get_filesize(filename) < messages * 24);
+    auto decoded = decode_file(filename, "%v");
+    REQUIRE(static_cast<size_t>(std::count(decoded.begin(), decoded.end(), '\n')) == messages);
+}
+
+TEST_CASE("binary preformatted fallback", "[binary]")
+{
+    prepare_logdir();
+    std::string filename = "logs/binary_log";
+    {
+        auto sink = std::make_shared<spdlog::sinks::binary_file_sink_mt>(filename);
+        spdlog::async_logger logger("async_binary", sink, 128);
+        logger.info("async message {}", 1);
+        logger.info("async message {}", 2);
+    }
+    REQUIRE(decode_file(filename, "%n %v") == "async_binary async message 1\nasync_binary async message 2\n");
+}
+
+TEST_CASE("binary reader rejects garbage", "[binary]")
+{
+    std::string garbage("\x07garbage");
+    spdlog::binary_reader reader(garbage.data(), garbage.size());
+    spdlog::details::log_msg msg;
+    REQUIRE_THROWS_AS(reader.next(msg), const spdlog::spdlog_ex &);
+}
+
+#endif
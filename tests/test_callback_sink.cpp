@@ -0,0 +1,160 @@
+/*
+ * This content is released under the MIT License as specified in https://raw.githubusercontent.com/gabime/spdlog/master/LICENSE
+ */
+#include "includes.h"
+#include "../include/spdlog/sinks/callback_sink.h"
+
+using spdlog::sinks::callback_payload;
+using spdlog::sinks::callback_record;
+using spdlog::sinks::callback_sink_mt;
+using spdlog::sinks::callback_sink_st;
+
+// the batches received by the callback, copied
+struct received_batches
+{
+    struct record
+    {
+        spdlog::level::level_enum level;
+        std::string logger_name;
+        std::string payload;
+    };
+
+    std::function<void(const callback_record *, size_t)> callback()
+    {
+        return [this](const callback_record *records, size_t count) {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::vector<record> batch;
+            for (size_t i = 0; i < count; i++)
+            {
+                batch.push_back(record{records[i].level, std::string(records[i].logger_name.data(), records[i].logger_name.size()),
+                    std::string(records[i].payload.data(), records[i].payload.size())});
+            }
+            batches.push_back(batch);
+        };
+    }
+
+    size_t size()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return batches.size();
+    }
+
+    std::mutex mutex;
+    std::vector<std::vector<record>> batches;
+};
+
+TEST_CASE("callback_sink delivers every max_messages messages", "[callback_sink]")
+{
+    received_batches received;
+    auto sink = std::make_shared<callback_sink_st>(received.callback(), 3);
+    spdlog::logger logger("callback", sink);
+
+    for (int i = 0; i < 7; i++)
+    {
+        logger.warn("message {}", i);
+    }
+    REQUIRE(received.batches.size() == 2);
+    REQUIRE(received.batches[0].size() == 3);
+    REQUIRE(received.batches[1].size() == 3);
+    REQUIRE(received.batches[1][2].payload == "message 5");
+    REQUIRE(received.batches[0][0].level == spdlog::level::warn);
+    REQUIRE(received.batches[0][0].logger_name == "callback");
+
+    // flush delivers the rest
+    logger.flush();
+    REQUIRE(received.batches.size() == 3);
+    REQUIRE(received.batches[2].size() == 1);
+    REQUIRE(received.batches[2][0].payload == "message 6");
+    logger.flush();
+    REQUIRE(received.batches.size() == 3);
+}
+
+TEST_CASE("callback_sink records of several loggers", "[callback_sink]")
+{
+    received_batches received;
+    auto sink = std::make_shared<callback_sink_st>(received.callback(), 100, std::chrono::milliseconds::zero(), callback_payload::formatted);
+    spdlog::logger first("first", sink);
+    spdlog::logger second("second", sink);
+    first.set_pattern("%n: %v");
+    second.set_pattern("%n: %v");
+
+    first.info("a");
+    first.info("b");
+    second.info("c");
+    first.info("d");
+    sink->flush();
+
+    REQUIRE(received.batches.size() == 1);
+    auto &batch = received.batches[0];
+    REQUIRE(batch.size() == 4);
+    std::vector<std::string> names, payloads;
+    for (auto &record : batch)
+    {
+        names.push_back(record.logger_name);
+        payloads.push_back(record.payload);
+    }
+    auto eol = std::string(spdlog::details::os::default_eol);
+    REQUIRE((names == std::vector<std::string>{"first", "first", "second", "first"}));
+    REQUIRE((payloads == std::vector<std::string>{"first: a" + eol, "first: b" + eol, "second: c" + eol, "first: d" + eol}));
+}
+
+TEST_CASE("callback_sink delivers after max_delay", "[callback_sink]")
+{
+    received_batches received;
+    auto sink = std::make_shared<callback_sink_st>(received.callback(), 1000, std::chrono::milliseconds(50));
+    spdlog::logger logger("callback", sink);
+
+    logger.info("1");
+    logger.info("2");
+    REQUIRE(received.batches.empty());
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    logger.info("3");
+    REQUIRE(received.batches.size() == 1);
+    REQUIRE(received.batches[0].size() == 3);
+}
+
+TEST_CASE("callback_sink with an async logger", "[callback_sink]")
+{
+    received_batches received;
+    auto sink = std::make_shared<callback_sink_mt>(received.callback(), 1000);
+    {
+        // the worker flushes the sink when idle
+        spdlog::async_logger logger("callback_async", sink, 128, spdlog::async_overflow_policy::block_retry, nullptr,
+            std::chrono::milliseconds(10));
+        logger.info("Hello");
+        for (int i = 0; i < 500 && received.size() == 0; i++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        REQUIRE(received.size() == 1);
+        REQUIRE(received.batches[0][0].payload == "Hello");
+        REQUIRE(received.batches[0][0].logger_name == "callback_async");
+    }
+}
+
+TEST_CASE("callback_sink starts a new batch when the callback throws", "[callback_sink]")
+{
+    int calls = 0;
+    size_t last_count = 0;
+    auto sink = std::make_shared<callback_sink_st>(
+        [&](const callback_record *, size_t count) {
+            calls++;
+            last_count = count;
+            if (calls == 1)
+            {
+                throw std::runtime_error("consumer failed");
+            }
+        },
+        2);
+    spdlog::logger logger("callback", sink);
+    std::string error;
+    logger.set_error_handler([&](const std::string &msg) { error = msg; });
+
+    logger.info("1");
+    logger.info("2");
+    REQUIRE(error == "consumer failed");
+    logger.info("3");
+    logger.info("4");
+    REQUIRE(calls == 2);
+    REQUIRE(last_count == 2);
+}
@@ -0,0 +1,187 @@
+/*
+ * This content is released under the MIT License as specified in https://raw.githubusercontent.com/gabime/spdlog/master/LICENSE
+ */
+#include "includes.h"
+#include "../include/spdlog/sinks/dup_filter_sink.h"
+#include "test_sink.h"
+
+using spdlog::sinks::dup_filter_sink_st;
+
+static std::shared_ptr<dup_filter_sink_st> make_dup_filter(std::ostringstream &oss, std::chrono::milliseconds max_skip_duration)
+{
+    auto dup_filter = std::make_shared<dup_filter_sink_st>(max_skip_duration);
+    dup_filter->add_sink(std::make_shared<spdlog::sinks::ostream_sink_st>(oss));
+    return dup_filter;
+}
+
+static std::string eol_lines(const std::string &text)
+{
+    std::string result;
+    std::istringstream iss(text);
+    std::string line;
+    while (std::getline(iss, line))
+    {
+        result += line + spdlog::details::os::default_eol;
+    }
+    return result;
+}
+
+TEST_CASE("dup_filter_sink skips duplicates", "[dup_filter_sink]")
+{
+    std::ostringstream oss;
+    spdlog::logger logger("logger", make_dup_filter(oss, std::chrono::seconds(5)));
+    logger.set_pattern("%v");
+
+    for (int i = 0; i < 10; i++)
+    {
+        logger.info("Hello");
+    }
+    logger.info("Different Hello");
+    logger.warn("Different Hello");
+    logger.info("Hello");
+
+    REQUIRE(oss.str() == eol_lines("Hello\nSkipped 9 duplicate messages..\nDifferent Hello\nDifferent Hello\nHello\n"));
+}
+
+TEST_CASE("dup_filter_sink max skip duration", "[dup_filter_sink]")
+{
+    std::ostringstream oss;
+    spdlog::logger logger("logger", make_dup_filter(oss, std::chrono::milliseconds(0)));
+    logger.set_pattern("%v");
+
+    logger.info("Hello");
+    logger.info("Hello");
+
+    REQUIRE(oss.str() == eol_lines("Hello\nHello\n"));
+}
+
+TEST_CASE("dup_filter_sink formats the skipped notice like the logger", "[dup_filter_sink]")
+{
+    std::ostringstream oss;
+    spdlog::logger logger("logger", make_dup_filter(oss, std::chrono::seconds(5)));
+    logger.set_pattern("[%n] [%l] %v");
+
+    logger.warn("Hello");
+    logger.warn("Hello");
+    logger.warn("Different Hello");
+
+    REQUIRE(oss.str() == eol_lines("[logger] [warning] Hello\n[logger] [warning] Skipped 1 duplicate messages..\n"
+                                   "[logger] [warning] Different Hello\n"));
+}
+
+TEST_CASE("dist_sink honors the levels of added sinks", "[dup_filter_sink]")
+{
+    std::ostringstream info_oss, err_oss;
+    auto err_sink = std::make_shared<spdlog::sinks::ostream_sink_st>(err_oss);
+    err_sink->set_level(spdlog::level::err);
+    spdlog::sinks::dist_sink_st dist;
+    dist.add_sink(std::make_shared<spdlog::sinks::ostream_sink_st>(info_oss));
+
+    spdlog::logger logger("dist", std::shared_ptr<spdlog::sinks::sink>(&dist, [](spdlog::sinks::sink *) {}));
+    logger.set_pattern("%v");
+    logger.info("1");
+    dist.add_sink(err_sink);
+    logger.info("2");
+    logger.error("3");
+    REQUIRE(info_oss.str() == eol_lines("1\n2\n3\n"));
+    REQUIRE(err_oss.str() == eol_lines("3\n"));
+
+    err_sink->set_level(spdlog::level::info);
+    logger.info("4");
+    REQUIRE(err_oss.str() == eol_lines("3\n4\n"));
+
+    REQUIRE(dist.sinks().size() == 2u);
+    REQUIRE(dist.sinks()[1] == err_sink);
+    dist.remove_all_sinks();
+    REQUIRE(dist.sinks().empty());
+    logger.error("5");
+    REQUIRE(err_oss.str() == eol_lines("3\n4\n"));
+}
+
+// not thread safe: counts the calls made while another one was running
+class overlap_counting_sink : public spdlog::sinks::sink
+{
+public:
+    void log(const spdlog::details::log_msg &) override
+    {
+        if (_inside.exchange(true))
+        {
+            overlaps++;
+        }
+        std::this_thread::yield();
+        messages++;
+        _inside = false;
+    }
+
+    void flush() override {}
+
+    std::atomic<size_t> overlaps{0};
+    size_t messages = 0;
+
+private:
+    std::atomic<bool> _inside{false};
+};
+
+TEST_CASE("dist_sink_mt serializes its sinks by default", "[dup_filter_sink]")
+{
+    auto dist = std::make_shared<spdlog::sinks::dist_sink_mt>();
+    auto st_sink = std::make_shared<overlap_counting_sink>();
+    dist->add_sink(st_sink);
+    spdlog::logger logger("dist_serialized", dist);
+
+    const size_t thread_count = 4;
+    const size_t messages = 2000;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < thread_count; t++)
+    {
+        threads.emplace_back([&] {
+            for (size_t i = 0; i < messages; i++)
+            {
+                logger.info("message {}", i);
+            }
+        });
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    REQUIRE(st_sink->overlaps == 0u);
+    REQUIRE(st_sink->messages == thread_count * messages);
+}
+
+TEST_CASE("dist_sink changes while logging", "[dup_filter_sink]")
+{
+    auto dist = std::make_shared<spdlog::sinks::dist_sink_mt>(spdlog::sinks::dist_sink_mode::concurrent);
+    auto steady_sink = std::make_shared<spdlog::sinks::test_sink_mt>();
+    dist->add_sink(steady_sink);
+    spdlog::logger logger("dist_mt", dist);
+
+    const size_t thread_count = 4;
+    const size_t messages = 10000;
+    std::atomic<bool> done{false};
+    std::thread mutator([&] {
+        while (!done)
+        {
+            auto extra = std::make_shared<spdlog::sinks::test_sink_mt>();
+            dist->add_sink(extra);
+            dist->remove_sink(extra);
+        }
+    });
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < thread_count; t++)
+    {
+        threads.emplace_back([&] {
+            for (size_t i = 0; i < messages; i++)
+            {
+                logger.info("message {}", i);
+            }
+        });
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    done = true;
+    mutator.join();
+    REQUIRE(steady_sink->msg_counter() == thread_count * messages);
+}
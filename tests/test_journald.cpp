@@ -0,0 +1,190 @@
+/*
+ * This content is released under the MIT License as specified in https://raw.githubusercontent.com/gabime/spdlog/master/LICENSE
+ */
+#include "includes.h"
+
+#ifdef __linux__
+
+#include "../include/spdlog/sinks/journald_sink.h"
+
+#include <map>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using spdlog::sinks::journald_sink_st;
+using journal_entry = std::map<std::string, std::string>;
+
+// a unix datagram socket standing for journald's
+class journal_receiver
+{
+public:
+    explicit journal_receiver(std::string path)
+        : _path(std::move(path))
+    {
+        ::unlink(_path.c_str());
+        _fd = ::socket(AF_UNIX, SOCK_DGRAM, 0);
+        REQUIRE(_fd != -1);
+        struct sockaddr_un addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, _path.c_str(), sizeof(addr.sun_path) - 1);
+        REQUIRE(::bind(_fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) == 0);
+    }
+
+    ~journal_receiver()
+    {
+        ::close(_fd);
+        ::unlink(_path.c_str());
+    }
+
+    const std::string &path() const
+    {
+        return _path;
+    }
+
+    // the next entry, read from the datagram or from the memfd passed with it. empty if there is none.
+    journal_entry receive()
+    {
+        std::vector<char> buf(256 * 1024);
+        union
+        {
+            struct cmsghdr align;
+            char buf[CMSG_SPACE(sizeof(int))];
+        } control;
+        struct iovec iov;
+        iov.iov_base = buf.data();
+        iov.iov_len = buf.size();
+        struct msghdr mh;
+        std::memset(&mh, 0, sizeof(mh));
+        mh.msg_iov = &iov;
+        mh.msg_iovlen = 1;
+        mh.msg_control = control.buf;
+        mh.msg_controllen = sizeof(control.buf);
+        auto size = ::recvmsg(_fd, &mh, MSG_DONTWAIT);
+        if (size < 0)
+        {
+            return journal_entry();
+        }
+        std::string data(buf.data(), static_cast<size_t>(size));
+        auto cmsg = CMSG_FIRSTHDR(&mh);
+        if (cmsg != nullptr && cmsg->cmsg_type == SCM_RIGHTS)
+        {
+            REQUIRE(data.empty());
+            int memfd;
+            std::memcpy(&memfd, CMSG_DATA(cmsg), sizeof(int));
+            char chunk[4096];
+            ssize_t n;
+            while ((n = ::pread(memfd, chunk, sizeof(chunk), static_cast<off_t>(data.size()))) > 0)
+            {
+                data.append(chunk, static_cast<size_t>(n));
+            }
+            ::close(memfd);
+        }
+        return parse(data);
+    }
+
+private:
+    static journal_entry parse(const std::string &data)
+    {
+        journal_entry entry;
+        size_t pos = 0;
+        while (pos < data.size())
+        {
+            auto eol = data.find('\n', pos);
+            REQUIRE(eol != std::string::npos);
+            auto eq = data.find('=', pos);
+            if (eq != std::string::npos && eq < eol)
+            {
+                entry[data.substr(pos, eq - pos)] = data.substr(eq + 1, eol - eq - 1);
+                pos = eol + 1;
+                continue;
+            }
+            // binary form: name, newline, 64 bit little endian size, value, newline
+            auto name = data.substr(pos, eol - pos);
+            uint64_t size = 0;
+            for (int i = 7; i >= 0; i--)
+            {
+                size = (size << 8) | static_cast<unsigned char>(data[eol + 1 + i]);
+            }
+            entry[name] = data.substr(eol + 9, size);
+            pos = eol + 9 + size;
+            REQUIRE(data[pos] == '\n');
+            pos++;
+        }
+        return entry;
+    }
+
+    std::string _path;
+    int _fd;
+};
+
+TEST_CASE("journald sink sends the fields", "[journald_sink]")
+{
+    prepare_logdir();
+    journal_receiver receiver("logs/journal_test.sock");
+    auto sink = std::make_shared<journald_sink_st>("spdlog-test", receiver.path());
+    sink->add_field("COMPONENT", "tests");
+    auto logger = std::make_shared<spdlog::logger>("journald", sink);
+    logger->set_pattern("[%l] %v");
+
+    SPDLOG_WARN(logger, "Hello {}", 1);
+    auto entry = receiver.receive();
+    REQUIRE(entry["MESSAGE"] == "Hello 1");
+    REQUIRE(entry["PRIORITY"] == "4");
+    REQUIRE(entry["SYSLOG_IDENTIFIER"] == "spdlog-test");
+    REQUIRE(entry["SPDLOG_LOGGER"] == "journald");
+    REQUIRE(entry["COMPONENT"] == "tests");
+    REQUIRE(entry["TID"] == std::to_string(spdlog::details::os::thread_id()));
+    REQUIRE(ends_with(entry["CODE_FILE"], "test_journald.cpp"));
+    REQUIRE(std::stoi(entry["CODE_LINE"]) > 0);
+    REQUIRE(!entry["CODE_FUNC"].empty());
+
+    // without source location
+    logger->error("Hello {}", 2);
+    entry = receiver.receive();
+    REQUIRE(entry["MESSAGE"] == "Hello 2");
+    REQUIRE(entry["PRIORITY"] == "3");
+    REQUIRE(entry.count("CODE_FILE") == 0);
+    REQUIRE(receiver.receive().empty());
+}
+
+TEST_CASE("journald sink sends multiline and large messages", "[journald_sink]")
+{
+    prepare_logdir();
+    journal_receiver receiver("logs/journal_test.sock");
+    auto sink = std::make_shared<journald_sink_st>("spdlog-test", receiver.path());
+    sink->add_field("MULTILINE_FIELD", "a\nb");
+    spdlog::logger logger("journald", sink);
+
+    logger.info("line 1\nline 2");
+    auto entry = receiver.receive();
+    REQUIRE(entry["MESSAGE"] == "line 1\nline 2");
+    REQUIRE(entry["MULTILINE_FIELD"] == "a\nb");
+
+    // larger than a datagram: passed in a memfd
+    std::string large(1024 * 1024, 'x');
+    logger.info(large);
+    entry = receiver.receive();
+    REQUIRE(entry["MESSAGE"] == large);
+    REQUIRE(entry["SYSLOG_IDENTIFIER"] == "spdlog-test");
+    REQUIRE(sink->dropped() == 0);
+}
+
+TEST_CASE("journald sink field names", "[journald_sink]")
+{
+    REQUIRE(journald_sink_st::valid_field_name("MY_FIELD_2"));
+    REQUIRE_FALSE(journald_sink_st::valid_field_name(""));
+    REQUIRE_FALSE(journald_sink_st::valid_field_name("_PID"));
+    REQUIRE_FALSE(journald_sink_st::valid_field_name("2FIELD"));
+    REQUIRE_FALSE(journald_sink_st::valid_field_name("lower"));
+    REQUIRE_FALSE(journald_sink_st::valid_field_name("WITH=EQUAL"));
+    REQUIRE_FALSE(journald_sink_st::valid_field_name(std::string(65, 'A')));
+
+    prepare_logdir();
+    journal_receiver receiver("logs/journal_test.sock");
+    journald_sink_st sink("spdlog-test", receiver.path());
+    REQUIRE_THROWS_AS(sink.add_field("bad", "value"), const spdlog::spdlog_ex &);
+}
+
+#endif // __linux__
@@ -4,7 +4,7 @@
 
 #include "includes.h"
 
-TEST_CASE("debug and trace w/o format string", "[macros]]")
+TEST_CASE("debug and trace w/o format string", "[macros]")
 {
     prepare_logdir();
     std::string filename = "logs/simple_log";
@@ -22,7 +22,7 @@ TEST_CASE("debug and trace w/o format string", "[macros]]")
     REQUIRE(count_lines(filename) == 2);
 }
 
-TEST_CASE("debug and trace with format strings", "[macros]]")
+TEST_CASE("debug and trace with format strings", "[macros]")
 {
     prepare_logdir();
     std::string filename = "logs/simple_log";
@@ -46,3 +46,200 @@ TEST_CASE("debug and trace with format strings", "[macros]]")
     REQUIRE(ends_with(file_contents(filename), "Test message 222\n"));
     REQUIRE(count_lines(filename) == 2);
 }
+
+static int evaluations = 0;
+static int expensive_arg()
+{
+    ++evaluations;
+    return 42;
+}
+
+TEST_CASE("level macros check the logger level before evaluating args", "[macros]")
+{
+    prepare_logdir();
+    std::string filename = "logs/simple_log";
+
+    auto logger = spdlog::create<spdlog::sinks::simple_file_sink_mt>("logger", filename);
+    logger->set_pattern("%v");
+    logger->set_level(spdlog::level::warn);
+
+    evaluations = 0;
+#if !defined(SPDLOG_FMT_PRINTF)
+    SPDLOG_DEBUG(logger, "Test message {}", expensive_arg());
+    SPDLOG_INFO(logger, "Test message {}", expensive_arg());
+    SPDLOG_WARN(logger, "Test message {}", expensive_arg());
+    SPDLOG_ERROR(logger, "Test message {}", expensive_arg());
+#else
+    SPDLOG_DEBUG(logger, "Test message %d", expensive_arg());
+    SPDLOG_INFO(logger, "Test message %d", expensive_arg());
+    SPDLOG_WARN(logger, "Test message %d", expensive_arg());
+    SPDLOG_ERROR(logger, "Test message %d", expensive_arg());
+#endif
+    SPDLOG_CRITICAL(logger, "Test message 2");
+    logger->flush();
+
+    REQUIRE(evaluations == 2);
+    REQUIRE(file_contents(filename) == "Test message 42\nTest message 42\nTest message 2\n");
+}
+
+static int logger_evaluations = 0;
+static std::shared_ptr<spdlog::logger> counted(std::shared_ptr<spdlog::logger> logger)
+{
+    logger_evaluations++;
+    return logger;
+}
+
+TEST_CASE("level macros evaluate the logger once", "[macros]")
+{
+    prepare_logdir();
+    std::string filename = "logs/simple_log";
+
+    auto logger = spdlog::create<spdlog::sinks::simple_file_sink_mt>("logger", filename);
+    logger->set_pattern("%v");
+    logger->set_level(spdlog::level::warn);
+    logger->enable_backtrace(4);
+
+    logger_evaluations = 0;
+    SPDLOG_INFO(counted(logger), "Test message 1");
+    SPDLOG_WARN(counted(logger), "Test message 2");
+    logger->flush();
+
+    REQUIRE(logger_evaluations == 2);
+    REQUIRE(file_contents(filename) == "Test message 2\n");
+}
+
+TEST_CASE("source location", "[macros]")
+{
+    prepare_logdir();
+    std::string filename = "logs/simple_log";
+
+    auto logger = spdlog::create<spdlog::sinks::simple_file_sink_mt>("logger", filename);
+    logger->set_pattern("[%s:%#] [%!] %v");
+
+    SPDLOG_INFO(logger, "Test message"); int line = __LINE__;
+    logger->info("Test message without location");
+    logger->flush();
+
+    auto expected = fmt::format("[test_macros.cpp:{}] [{}] Test message\n[:] [] Test message without location\n", line, __FUNCTION__);
+    REQUIRE(file_contents(filename) == expected);
+}
+
+TEST_CASE("source location basename", "[macros]")
+{
+    REQUIRE(std::string(spdlog::source_loc("/a/b/file.cpp", 1, "f").basename) == "file.cpp");
+    REQUIRE(std::string(spdlog::source_loc("a\\b\\file.cpp", 1, "f").basename) == "file.cpp");
+    REQUIRE(std::string(spdlog::source_loc("file.cpp", 1, "f").basename) == "file.cpp");
+    REQUIRE(spdlog::source_loc().empty());
+}
+
+static void log_from_helper(std::shared_ptr<spdlog::logger> logger)
+{
+    SPDLOG_DEBUG(logger, "debug from helper");
+}
+
+TEST_CASE("log sites enabled at runtime", "[macros]")
+{
+    prepare_logdir();
+    std::string filename = "logs/simple_log";
+
+    auto logger = spdlog::create<spdlog::sinks::simple_file_sink_mt>("logger", filename);
+    logger->set_pattern("%v");
+    logger->set_level(spdlog::level::info);
+
+    log_from_helper(logger);
+    spdlog::set_log_sites_by_function("log_from_*", spdlog::log_site_state::enabled);
+    log_from_helper(logger);
+    spdlog::set_log_sites_by_logger("logger", spdlog::log_site_state::disabled);
+    log_from_helper(logger);
+    SPDLOG_INFO(logger, "info disabled by logger");
+    spdlog::set_log_sites_by_file("*macros.cpp", spdlog::log_site_state::enabled);
+    SPDLOG_DEBUG(logger, "debug enabled by file");
+    spdlog::reset_log_sites();
+    log_from_helper(logger);
+    SPDLOG_INFO(logger, "info");
+    logger->flush();
+
+    REQUIRE(file_contents(filename) == "debug from helper\ndebug enabled by file\ninfo\n");
+}
+
+TEST_CASE("glob match", "[macros]")
+{
+    using spdlog::details::glob_match;
+    REQUIRE(glob_match("*", ""));
+    REQUIRE(glob_match("*.cpp", "/src/net/conn.cpp"));
+    REQUIRE(glob_match("*/net/*", "/src/net/conn.cpp"));
+    REQUIRE(glob_match("con?.cpp", "conn.cpp"));
+    REQUIRE(glob_match("a*b*c", "aXbYbZc"));
+    REQUIRE_FALSE(glob_match("*.h", "/src/net/conn.cpp"));
+    REQUIRE_FALSE(glob_match("conn", "conn.cpp"));
+}
+
+#if !defined(SPDLOG_FMT_PRINTF)
+static void warn_every(std::shared_ptr<spdlog::logger> logger, int i)
+{
+    SPDLOG_WARN_EVERY(logger, std::chrono::milliseconds(50), "Test message {}", i);
+}
+
+TEST_CASE("rate limited macros", "[macros]")
+{
+    prepare_logdir();
+    std::string filename = "logs/simple_log";
+
+    auto logger = spdlog::create<spdlog::sinks::simple_file_sink_mt>("logger", filename);
+    logger->set_pattern("%v");
+
+    for (int i = 0; i < 10; i++)
+    {
+        SPDLOG_INFO_EVERY_N(logger, 4, "every n {}", i);
+        SPDLOG_INFO_SAMPLED(logger, 0.0, "never");
+        SPDLOG_DEBUG_EVERY_N(logger, 1, "debug level disabled");
+    }
+    warn_every(logger, 1);
+    warn_every(logger, 2);
+    warn_every(logger, 3);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    warn_every(logger, 4);
+    logger->flush();
+
+    REQUIRE(file_contents(filename) == "every n 0\nevery n 4\n3 similar messages suppressed\nevery n 8\n3 similar messages suppressed\n"
+                                       "Test message 1\nTest message 4\n2 similar messages suppressed\n");
+}
+
+TEST_CASE("rate limited logger methods", "[macros]")
+{
+    prepare_logdir();
+    std::string filename = "logs/simple_log";
+
+    auto logger = spdlog::create<spdlog::sinks::simple_file_sink_mt>("logger", filename);
+    logger->set_pattern("%v");
+
+    spdlog::log_limiter every_n_limiter, every_limiter, sampled_limiter, other_every_n_limiter;
+    for (int i = 0; i < 5; i++)
+    {
+        logger->warn_every_n(every_n_limiter, 2, "every n {}", i);
+        logger->warn_every(every_limiter, std::chrono::hours(1), "every hour {}", i);
+        logger->log_sampled(sampled_limiter, spdlog::level::info, 1.0, "always {}", i);
+    }
+    // same format string, other call site
+    logger->warn_every_n(other_every_n_limiter, 2, "every n {}", 5);
+    logger->flush();
+
+    REQUIRE(file_contents(filename) == "every n 0\nevery hour 0\nalways 0\nalways 1\nevery n 2\n1 similar messages suppressed\n"
+                                       "always 2\nalways 3\nevery n 4\n1 similar messages suppressed\nalways 4\nevery n 5\n");
+}
+
+#endif
+
+TEST_CASE("log limiter sampling", "[macros]")
+{
+    spdlog::details::log_limiter limiter;
+    int passed = 0;
+    for (int i = 0; i < 10000; i++)
+    {
+        passed += limiter.sampled(0.25) ? 1 : 0;
+    }
+    REQUIRE(passed > 2000);
+    REQUIRE(passed < 3000);
+    REQUIRE(limiter.take_suppressed() == static_cast<uint64_t>(10000 - passed));
+    REQUIRE(limiter.take_suppressed() == 0);
+}
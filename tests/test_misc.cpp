@@ -1,4 +1,5 @@
 #include "includes.h"
+#include "../include/spdlog/details/tsc_clock.h"
 
 template<class T>
 std::string log_info(const T &what, spdlog::level::level_enum logger_level = spdlog::level::info)
@@ -75,3 +76,217 @@ TEST_CASE("to_level_enum", "[convert_to_level_enum]")
     REQUIRE(spdlog::level::from_str("off") == spdlog::level::off);
     REQUIRE(spdlog::level::from_str("null") == spdlog::level::off);
 }
+
+TEST_CASE("tsc clock", "[tsc_clock]")
+{
+    auto &clock = spdlog::details::tsc_clock::instance();
+    auto t1 = clock.ticks();
+    auto now = spdlog::log_clock::now();
+    auto t2 = clock.ticks();
+    REQUIRE(t2 >= t1);
+
+    // converted to the system clock time until the first calibration, and with it afterwards
+    auto diff = std::chrono::duration_cast<std::chrono::milliseconds>(clock.to_time_point(t1) - now).count();
+    REQUIRE(std::abs(diff) < 50);
+    spdlog::details::tsc_clock::init();
+    diff = std::chrono::duration_cast<std::chrono::milliseconds>(clock.to_time_point(t1) - now).count();
+    REQUIRE(std::abs(diff) < 50);
+}
+
+TEST_CASE("sink levels", "[sink_levels]")
+{
+    std::ostringstream info_oss, warn_oss;
+    auto info_sink = std::make_shared<spdlog::sinks::ostream_sink_st>(info_oss);
+    auto warn_sink = std::make_shared<spdlog::sinks::ostream_sink_st>(warn_oss);
+    warn_sink->set_level(spdlog::level::warn);
+
+    spdlog::logger logger("sinks", {info_sink, warn_sink});
+    logger.set_pattern("%v");
+    logger.info("1");
+    logger.warn("2");
+    REQUIRE(info_oss.str() == std::string("1") + spdlog::details::os::default_eol + "2" + spdlog::details::os::default_eol);
+    REQUIRE(warn_oss.str() == std::string("2") + spdlog::details::os::default_eol);
+
+    // level changes after logging are taken into account
+    info_sink->set_level(spdlog::level::off);
+    warn_sink->set_level(spdlog::level::info);
+    info_oss.str("");
+    warn_oss.str("");
+    logger.info("3");
+    REQUIRE(info_oss.str().empty());
+    REQUIRE(warn_oss.str() == std::string("3") + spdlog::details::os::default_eol);
+}
+
+TEST_CASE("sink levels with more sinks than the dispatch masks hold", "[sink_levels]")
+{
+    std::vector<spdlog::sink_ptr> sinks;
+    for (size_t i = 0; i < spdlog::details::sink_dispatch_table::max_sinks + 1; i++)
+    {
+        sinks.push_back(std::make_shared<spdlog::sinks::null_sink_st>());
+    }
+    std::ostringstream oss;
+    auto last = std::make_shared<spdlog::sinks::ostream_sink_st>(oss);
+    last->set_level(spdlog::level::warn);
+    sinks.push_back(last);
+
+    spdlog::logger logger("sinks", sinks.begin(), sinks.end());
+    logger.set_pattern("%v");
+    logger.info("1");
+    logger.warn("2");
+    REQUIRE(oss.str() == std::string("2") + spdlog::details::os::default_eol);
+}
+
+TEST_CASE("sink levels changed while logging", "[sink_levels]")
+{
+    std::ostringstream oss;
+    auto changed = std::make_shared<spdlog::sinks::ostream_sink_mt>(oss);
+    auto other = std::make_shared<spdlog::sinks::null_sink_mt>();
+    spdlog::logger logger("sinks", {other, changed});
+    logger.set_pattern("%v");
+
+    std::atomic<bool> done{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 2; t++)
+    {
+        threads.emplace_back([&] {
+            while (!done)
+            {
+                logger.info("x");
+            }
+        });
+    }
+    for (int i = 0; i < 1000; i++)
+    {
+        changed->set_level(i % 2 == 0 ? spdlog::level::off : spdlog::level::trace);
+        other->set_level(i % 3 == 0 ? spdlog::level::off : spdlog::level::trace);
+    }
+    changed->set_level(spdlog::level::off);
+    done = true;
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+
+    // the last level change is never lost
+    auto before = oss.str().size();
+    logger.info("after");
+    REQUIRE(oss.str().size() == before);
+}
+
+TEST_CASE("flush policies", "[flush_policy]")
+{
+    using spdlog::sinks::flush_policy;
+
+    spdlog::details::flush_tracker every_message(flush_policy::every_message());
+    REQUIRE(every_message.should_flush(spdlog::level::trace, 1));
+
+    spdlog::details::flush_tracker every_bytes(flush_policy::every_bytes(10));
+    REQUIRE_FALSE(every_bytes.should_flush(spdlog::level::critical, 4));
+    REQUIRE_FALSE(every_bytes.should_flush(spdlog::level::info, 5));
+    REQUIRE(every_bytes.should_flush(spdlog::level::info, 1));
+    every_bytes.flushed();
+    REQUIRE_FALSE(every_bytes.should_flush(spdlog::level::info, 9));
+
+    spdlog::details::flush_tracker on_level(flush_policy::on_level(spdlog::level::warn));
+    REQUIRE_FALSE(on_level.should_flush(spdlog::level::info, 1000000));
+    REQUIRE(on_level.should_flush(spdlog::level::warn, 1));
+    REQUIRE(on_level.should_flush(spdlog::level::critical, 1));
+
+    spdlog::details::flush_tracker every_interval(flush_policy::every_interval(std::chrono::milliseconds(20)));
+    REQUIRE_FALSE(every_interval.should_flush(spdlog::level::critical, 1000000));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    REQUIRE(every_interval.should_flush(spdlog::level::info, 1));
+    every_interval.flushed();
+    REQUIRE_FALSE(every_interval.should_flush(spdlog::level::info, 1));
+
+    // combined
+    auto policy = flush_policy::every_bytes(100);
+    policy.flush_level = spdlog::level::err;
+    spdlog::details::flush_tracker combined(policy);
+    REQUIRE_FALSE(combined.should_flush(spdlog::level::info, 10));
+    REQUIRE(combined.should_flush(spdlog::level::err, 10));
+    combined.flushed();
+    REQUIRE(combined.should_flush(spdlog::level::info, 100));
+}
+
+#ifdef __GLIBC__
+// stream recording the writes reaching the file: what stdio flushes if buffered, each fwrite if not
+struct write_recorder
+{
+    explicit write_recorder(bool buffered)
+    {
+        cookie_io_functions_t io = {nullptr, &write_recorder::write, nullptr, nullptr};
+        file = fopencookie(this, "w", io);
+        setvbuf(file, nullptr, buffered ? _IOFBF : _IONBF, 64 * 1024);
+    }
+
+    ~write_recorder()
+    {
+        fclose(file);
+    }
+
+    static ssize_t write(void *cookie, const char *buf, size_t size)
+    {
+        static_cast<write_recorder *>(cookie)->writes.emplace_back(buf, size);
+        return static_cast<ssize_t>(size);
+    }
+
+    FILE *file;
+    std::vector<std::string> writes;
+};
+
+static std::string eol_line(const std::string &text)
+{
+    return text + spdlog::details::os::default_eol;
+}
+
+TEST_CASE("console sinks with a flush policy", "[flush_policy]")
+{
+    using spdlog::sinks::flush_policy;
+    using color_sink_st = spdlog::sinks::ansicolor_sink<spdlog::details::null_mutex>;
+
+    write_recorder out(true);
+    auto sink = std::make_shared<color_sink_st>(out.file, flush_policy::every_bytes(20));
+    spdlog::logger logger("buffered_console", sink);
+    logger.set_pattern("%v");
+
+    // buffered until 20 bytes were written
+    logger.info("12345");
+    logger.info("12345");
+    REQUIRE(out.writes.empty());
+    logger.info("1234567890");
+    REQUIRE(out.writes.size() == 1u);
+    REQUIRE(out.writes[0] == eol_line("12345") + eol_line("12345") + eol_line("1234567890"));
+
+    // buffered until an error
+    sink->set_flush_policy(flush_policy::on_level(spdlog::level::err));
+    logger.info("info");
+    REQUIRE(out.writes.size() == 1u);
+    logger.error("error");
+    REQUIRE(out.writes.size() == 2u);
+    REQUIRE(out.writes[1] == eol_line("info") + eol_line("error"));
+
+    // flushed on demand
+    logger.info("flushed");
+    REQUIRE(out.writes.size() == 2u);
+    logger.flush();
+    REQUIRE(out.writes.size() == 3u);
+    REQUIRE(out.writes[2] == eol_line("flushed"));
+}
+
+TEST_CASE("console sinks write a colored line at once", "[flush_policy]")
+{
+    using color_sink_st = spdlog::sinks::ansicolor_sink<spdlog::details::null_mutex>;
+
+    // unbuffered: each fwrite reaches the recorder
+    write_recorder out(false);
+    auto sink = std::make_shared<color_sink_st>(out.file);
+    sink->set_colors_enabled(true);
+    spdlog::logger logger("colored_console", sink);
+    logger.set_pattern("[%^%l%$] %v");
+
+    logger.info("Hello");
+    REQUIRE(out.writes.size() == 1u);
+    REQUIRE(out.writes[0] == eol_line("[" + sink->green + "info" + sink->reset + "] Hello"));
+}
+#endif
@@ -0,0 +1,178 @@
+/*
+ * This content is released under the MIT License as specified in https://raw.githubusercontent.com/gabime/spdlog/master/LICENSE
+ */
+#include "includes.h"
+
+#ifndef _WIN32
+
+#include "../include/spdlog/sinks/native_syslog_sink.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using spdlog::sinks::flush_policy;
+using spdlog::sinks::native_syslog_sink_st;
+using spdlog::sinks::syslog_format;
+
+// a unix datagram socket standing for /dev/log
+class syslog_receiver
+{
+public:
+    explicit syslog_receiver(std::string path)
+        : _path(std::move(path))
+    {
+        ::unlink(_path.c_str());
+        _fd = ::socket(AF_UNIX, SOCK_DGRAM, 0);
+        REQUIRE(_fd != -1);
+        struct sockaddr_un addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, _path.c_str(), sizeof(addr.sun_path) - 1);
+        REQUIRE(::bind(_fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) == 0);
+    }
+
+    ~syslog_receiver()
+    {
+        ::close(_fd);
+        ::unlink(_path.c_str());
+    }
+
+    const std::string &path() const
+    {
+        return _path;
+    }
+
+    // the next datagram, or an empty string if there is none
+    std::string receive()
+    {
+        char buf[4096];
+        auto size = ::recv(_fd, buf, sizeof(buf), MSG_DONTWAIT);
+        return size > 0 ? std::string(buf, static_cast<size_t>(size)) : std::string();
+    }
+
+private:
+    std::string _path;
+    int _fd;
+};
+
+TEST_CASE("native syslog sink sends rfc3164 datagrams", "[native_syslog_sink]")
+{
+    prepare_logdir();
+    syslog_receiver receiver("logs/syslog_test.sock");
+    auto sink = std::make_shared<native_syslog_sink_st>("spdlog-test", 1 << 3, receiver.path());
+    spdlog::logger logger("native_syslog", sink);
+
+    logger.info("Hello {}", 1);
+    logger.error("Hello {}", 2);
+
+    auto first = receiver.receive();
+    auto pid = std::to_string(spdlog::details::os::pid());
+    REQUIRE(first.substr(0, 4) == "<14>");
+    REQUIRE(first.find(" spdlog-test[" + pid + "]: ") != std::string::npos);
+    REQUIRE(ends_with(first, "]: Hello 1"));
+
+    auto second = receiver.receive();
+    REQUIRE(second.substr(0, 4) == "<11>");
+    REQUIRE(ends_with(second, "]: Hello 2"));
+    REQUIRE(receiver.receive().empty());
+}
+
+TEST_CASE("native syslog sink sends rfc5424 datagrams", "[native_syslog_sink]")
+{
+    prepare_logdir();
+    syslog_receiver receiver("logs/syslog_test.sock");
+    auto sink = std::make_shared<native_syslog_sink_st>("spdlog-test", 3 << 3, receiver.path(), syslog_format::rfc5424);
+    spdlog::logger logger("native_syslog", sink);
+
+    logger.warn("Hello");
+
+    auto datagram = receiver.receive();
+    REQUIRE(datagram.substr(0, 7) == "<28>1 2");
+    REQUIRE(datagram.find("Z ") == 32); // <28>1 yyyy-mm-ddThh:mm:ss.uuuuuuZ
+    REQUIRE(ends_with(datagram, " spdlog-test " + std::to_string(spdlog::details::os::pid()) + " - - Hello"));
+}
+
+TEST_CASE("native syslog sink batches messages", "[native_syslog_sink]")
+{
+    prepare_logdir();
+    syslog_receiver receiver("logs/syslog_test.sock");
+    auto sink = std::make_shared<native_syslog_sink_st>(
+        "spdlog-test", 1 << 3, receiver.path(), syslog_format::rfc3164, flush_policy::on_level(spdlog::level::err));
+    spdlog::logger logger("native_syslog", sink);
+
+    logger.info("1");
+    logger.info("2");
+    REQUIRE(receiver.receive().empty());
+
+    logger.error("3");
+    REQUIRE(ends_with(receiver.receive(), ": 1"));
+    REQUIRE(ends_with(receiver.receive(), ": 2"));
+    REQUIRE(ends_with(receiver.receive(), ": 3"));
+
+    logger.info("4");
+    REQUIRE(receiver.receive().empty());
+    logger.flush();
+    REQUIRE(ends_with(receiver.receive(), ": 4"));
+
+    // a full batch is sent regardless of the policy
+    for (size_t i = 0; i < native_syslog_sink_st::max_batch; i++)
+    {
+        logger.info("x");
+    }
+    // the socket's queue might be shorter than a batch (net.unix.max_dgram_qlen)
+    size_t received = 0;
+    for (auto datagram = receiver.receive(); !datagram.empty(); datagram = receiver.receive())
+    {
+        REQUIRE(ends_with(datagram, ": x"));
+        received++;
+    }
+    REQUIRE(received > 0);
+    auto total = received + sink->dropped();
+    REQUIRE(total == native_syslog_sink_st::max_batch);
+}
+
+TEST_CASE("native syslog sink drops messages instead of blocking", "[native_syslog_sink]")
+{
+    prepare_logdir();
+    syslog_receiver receiver("logs/syslog_test.sock");
+    auto sink = std::make_shared<native_syslog_sink_st>("spdlog-test", 1 << 3, receiver.path());
+    spdlog::logger logger("native_syslog", sink);
+
+    // nobody reads the socket: its queue fills up
+    const size_t messages = 100000;
+    for (size_t i = 0; i < messages; i++)
+    {
+        logger.info("Hello {}", i);
+    }
+    REQUIRE(sink->dropped() > 0);
+    REQUIRE(sink->dropped() < messages);
+    REQUIRE(receiver.receive() != "");
+}
+
+TEST_CASE("native syslog sink reconnects", "[native_syslog_sink]")
+{
+    prepare_logdir();
+    std::shared_ptr<native_syslog_sink_st> sink;
+    {
+        syslog_receiver receiver("logs/syslog_test.sock");
+        sink = std::make_shared<native_syslog_sink_st>("spdlog-test", 1 << 3, receiver.path());
+    }
+    spdlog::logger logger("native_syslog", sink);
+    logger.info("lost");
+    REQUIRE(sink->dropped() == 1);
+
+    // the daemon restarted
+    syslog_receiver receiver("logs/syslog_test.sock");
+    logger.info("Hello");
+    REQUIRE(ends_with(receiver.receive(), ": Hello"));
+    REQUIRE(sink->dropped() == 1);
+}
+
+TEST_CASE("native syslog sink fails without a socket", "[native_syslog_sink]")
+{
+    prepare_logdir();
+    REQUIRE_THROWS_AS(std::make_shared<native_syslog_sink_st>("spdlog-test", 1 << 3, "logs/no_such.sock"), const spdlog::spdlog_ex &);
+}
+
+#endif // _WIN32
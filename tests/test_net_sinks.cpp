@@ -0,0 +1,272 @@
+/*
+ * This content is released under the MIT License as specified in https://raw.githubusercontent.com/gabime/spdlog/master/LICENSE
+ */
+#include "includes.h"
+
+#ifndef _WIN32
+
+#include "../include/spdlog/sinks/tcp_sink.h"
+#include "../include/spdlog/sinks/udp_sink.h"
+
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using spdlog::sinks::flush_policy;
+
+// a socket bound to a loopback port
+class loopback_socket
+{
+public:
+    explicit loopback_socket(int type, int port = 0)
+    {
+        _fd = ::socket(AF_INET, type, 0);
+        REQUIRE(_fd != -1);
+        int on = 1;
+        ::setsockopt(_fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        struct sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        REQUIRE(::bind(_fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) == 0);
+        socklen_t len = sizeof(addr);
+        REQUIRE(::getsockname(_fd, reinterpret_cast<struct sockaddr *>(&addr), &len) == 0);
+        _port = ntohs(addr.sin_port);
+        if (type == SOCK_STREAM)
+        {
+            REQUIRE(::listen(_fd, 8) == 0);
+        }
+    }
+
+    ~loopback_socket()
+    {
+        ::close(_fd);
+        if (_client != -1)
+        {
+            ::close(_client);
+        }
+    }
+
+    int port() const
+    {
+        return _port;
+    }
+
+    // the next datagram, or an empty string if none arrives within timeout_ms
+    std::string receive_datagram(int timeout_ms = 0)
+    {
+        if (!wait_readable(_fd, timeout_ms))
+        {
+            return std::string();
+        }
+        char buf[4096];
+        auto size = ::recv(_fd, buf, sizeof(buf), 0);
+        return size > 0 ? std::string(buf, static_cast<size_t>(size)) : std::string();
+    }
+
+    // accept a connection and read from it until size bytes were received or nothing arrives for timeout_ms
+    std::string receive_stream(size_t size, int timeout_ms = 2000)
+    {
+        if (_client == -1)
+        {
+            if (!wait_readable(_fd, timeout_ms))
+            {
+                return std::string();
+            }
+            _client = ::accept(_fd, nullptr, nullptr);
+        }
+        std::string result;
+        while (result.size() < size && wait_readable(_client, timeout_ms))
+        {
+            char buf[4096];
+            auto n = ::recv(_client, buf, sizeof(buf), 0);
+            if (n <= 0)
+            {
+                break;
+            }
+            result.append(buf, static_cast<size_t>(n));
+        }
+        return result;
+    }
+
+private:
+    static bool wait_readable(int fd, int timeout_ms)
+    {
+        struct pollfd pfd;
+        pfd.fd = fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        return ::poll(&pfd, 1, timeout_ms) == 1;
+    }
+
+    int _fd;
+    int _client{-1};
+    int _port;
+};
+
+static std::string lines(std::initializer_list<const char *> texts)
+{
+    std::string result;
+    for (auto text : texts)
+    {
+        result += text;
+        result += spdlog::details::os::default_eol;
+    }
+    return result;
+}
+
+TEST_CASE("udp sink sends a datagram per message", "[net_sinks]")
+{
+    loopback_socket receiver(SOCK_DGRAM);
+    auto sink = std::make_shared<spdlog::sinks::udp_sink_st>("127.0.0.1", receiver.port());
+    spdlog::logger logger("udp", sink);
+    logger.set_pattern("%v");
+
+    logger.info("Hello {}", 1);
+    logger.info("Hello {}", 2);
+    REQUIRE(receiver.receive_datagram(1000) == lines({"Hello 1"}));
+    REQUIRE(receiver.receive_datagram(1000) == lines({"Hello 2"}));
+    REQUIRE(receiver.receive_datagram() == "");
+    REQUIRE(sink->dropped() == 0);
+}
+
+TEST_CASE("udp sink batches messages", "[net_sinks]")
+{
+    loopback_socket receiver(SOCK_DGRAM);
+    auto sink = std::make_shared<spdlog::sinks::udp_sink_st>("127.0.0.1", receiver.port(), flush_policy::every_bytes(1024 * 1024));
+    spdlog::logger logger("udp", sink);
+    logger.set_pattern("%v");
+
+    logger.info("1");
+    logger.info("2");
+    REQUIRE(receiver.receive_datagram(50) == "");
+    logger.flush();
+    REQUIRE(receiver.receive_datagram(1000) == lines({"1"}));
+    REQUIRE(receiver.receive_datagram(1000) == lines({"2"}));
+
+    // a full batch is sent regardless of the policy
+    for (size_t i = 0; i < spdlog::sinks::udp_sink_st::max_batch; i++)
+    {
+        logger.info("x");
+    }
+    size_t received = 0;
+    while (receiver.receive_datagram(100) == lines({"x"}))
+    {
+        received++;
+    }
+    auto total = received + sink->dropped();
+    REQUIRE(received > 0);
+    REQUIRE(total == spdlog::sinks::udp_sink_st::max_batch);
+}
+
+TEST_CASE("udp sink fails on unknown hosts", "[net_sinks]")
+{
+    REQUIRE_THROWS_AS(spdlog::sinks::udp_sink_st("no.such.host.invalid", 514), const spdlog::spdlog_ex &);
+}
+
+TEST_CASE("udp sink sends after a refused datagram", "[net_sinks]")
+{
+    int port;
+    {
+        // a free port, nobody listening on it
+        loopback_socket probe(SOCK_DGRAM);
+        port = probe.port();
+    }
+    auto sink = std::make_shared<spdlog::sinks::udp_sink_st>("127.0.0.1", port);
+    spdlog::logger logger("udp", sink);
+    logger.set_pattern("%v");
+
+    logger.info("refused");
+    // let the refusal reach the socket
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    loopback_socket receiver(SOCK_DGRAM, port);
+    logger.info("Hello");
+    REQUIRE(receiver.receive_datagram(1000) == lines({"Hello"}));
+    REQUIRE(sink->dropped() == 0);
+}
+
+TEST_CASE("tcp sink fails on unknown hosts", "[net_sinks]")
+{
+    REQUIRE_THROWS_AS(spdlog::sinks::tcp_sink_st("no.such.host.invalid", 514), const spdlog::spdlog_ex &);
+}
+
+TEST_CASE("tcp sink writes messages to the connection", "[net_sinks]")
+{
+    loopback_socket receiver(SOCK_STREAM);
+    auto sink = std::make_shared<spdlog::sinks::tcp_sink_st>("127.0.0.1", receiver.port());
+    spdlog::logger logger("tcp", sink);
+    logger.set_pattern("%v");
+
+    logger.info("Hello {}", 1);
+    logger.info("Hello {}", 2);
+    auto expected = lines({"Hello 1", "Hello 2"});
+    REQUIRE(receiver.receive_stream(expected.size()) == expected);
+    REQUIRE(sink->connected());
+    REQUIRE(sink->dropped() == 0);
+}
+
+TEST_CASE("tcp sink buffers messages", "[net_sinks]")
+{
+    loopback_socket receiver(SOCK_STREAM);
+    auto sink = std::make_shared<spdlog::sinks::tcp_sink_st>("127.0.0.1", receiver.port(), flush_policy::on_level(spdlog::level::err));
+    spdlog::logger logger("tcp", sink);
+    logger.set_pattern("%v");
+
+    logger.info("1");
+    REQUIRE(receiver.receive_stream(1, 50) == "");
+    logger.error("2");
+    auto expected = lines({"1", "2"});
+    REQUIRE(receiver.receive_stream(expected.size()) == expected);
+}
+
+TEST_CASE("tcp sink reconnects and keeps messages meanwhile", "[net_sinks]")
+{
+    int port;
+    {
+        // a free port, nobody listening on it
+        loopback_socket probe(SOCK_DGRAM);
+        port = probe.port();
+    }
+    auto sink = std::make_shared<spdlog::sinks::tcp_sink_st>("127.0.0.1", port);
+    sink->set_reconnect_backoff(std::chrono::milliseconds(1), std::chrono::milliseconds(20));
+    spdlog::logger logger("tcp", sink);
+    logger.set_pattern("%v");
+
+    logger.info("1");
+    REQUIRE_FALSE(sink->connected());
+
+    loopback_socket receiver(SOCK_STREAM, port);
+    for (int i = 0; i < 100 && !sink->connected(); i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        logger.flush();
+    }
+    REQUIRE(sink->connected());
+    logger.info("2");
+    auto expected = lines({"1", "2"});
+    REQUIRE(receiver.receive_stream(expected.size()) == expected);
+    REQUIRE(sink->dropped() == 0);
+}
+
+TEST_CASE("tcp sink bounds its buffer while disconnected", "[net_sinks]")
+{
+    int port;
+    {
+        loopback_socket probe(SOCK_DGRAM);
+        port = probe.port();
+    }
+    auto sink = std::make_shared<spdlog::sinks::tcp_sink_st>("127.0.0.1", port, flush_policy::every_message(), 100);
+    spdlog::logger logger("tcp", sink);
+    logger.set_pattern("%v");
+
+    for (int i = 0; i < 20; i++)
+    {
+        logger.info("123456789");
+    }
+    // 10 messages of 10 bytes fit
+    REQUIRE(sink->dropped() == 20 - 100 / lines({"123456789"}).size());
+}
+
+#endif // _WIN32
@@ -122,3 +122,65 @@ TEST_CASE("color range test6", "[pattern_formatter]")
     REQUIRE(msg.color_range_start == 0);
     REQUIRE(msg.color_range_end == 2);
 }
+
+TEST_CASE("capture flags", "[pattern_formatter]")
+{
+    REQUIRE(spdlog::pattern_formatter("%v").capture_flags() == spdlog::capture::none);
+    REQUIRE(spdlog::pattern_formatter("[%n] [%l] %v %P").capture_flags() == spdlog::capture::none);
+    REQUIRE(spdlog::pattern_formatter("%t %v").capture_flags() == spdlog::capture::thread_id);
+    REQUIRE(spdlog::pattern_formatter("%H:%M %v").capture_flags() == spdlog::capture::time);
+    REQUIRE(spdlog::pattern_formatter("%+ %t").capture_flags() == (spdlog::capture::time | spdlog::capture::thread_id));
+}
+
+// reads msg.time and msg.thread_id without declaring it, like sinks written before capture flags
+class capture_sink : public spdlog::sinks::base_sink<spdlog::details::null_mutex>
+{
+public:
+    spdlog::log_clock::time_point last_time;
+    size_t last_thread_id = 0;
+
+protected:
+    void _sink_it(const spdlog::details::log_msg &msg) override
+    {
+        last_time = msg.time;
+        last_thread_id = msg.thread_id;
+    }
+    void _flush() override {}
+};
+
+// declares it reads only msg.formatted
+class formatted_only_sink : public capture_sink
+{
+public:
+    unsigned capture_flags() const override
+    {
+        return spdlog::capture::none;
+    }
+};
+
+TEST_CASE("capture only fields used by pattern", "[pattern_formatter]")
+{
+    auto sink = std::make_shared<formatted_only_sink>();
+    spdlog::logger logger("capture_tester", sink);
+
+    logger.set_pattern("%v");
+    logger.info("no time, no thread id");
+    REQUIRE(sink->last_time == spdlog::log_clock::time_point());
+    REQUIRE(sink->last_thread_id == 0);
+
+    logger.set_pattern("%T %t %v");
+    logger.info("time and thread id");
+    REQUIRE(sink->last_time != spdlog::log_clock::time_point());
+    REQUIRE(sink->last_thread_id == spdlog::details::os::thread_id());
+}
+
+TEST_CASE("capture all fields for sinks not declaring theirs", "[pattern_formatter]")
+{
+    auto sink = std::make_shared<capture_sink>();
+    spdlog::logger logger("capture_tester", sink);
+
+    logger.set_pattern("%v");
+    logger.info("time and thread id");
+    REQUIRE(sink->last_time != spdlog::log_clock::time_point());
+    REQUIRE(sink->last_thread_id == spdlog::details::os::thread_id());
+}
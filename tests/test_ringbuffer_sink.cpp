@@ -0,0 +1,111 @@
+/*
+ * This content is released under the MIT License as specified in https://raw.githubusercontent.com/gabime/spdlog/master/LICENSE
+ */
+#include "includes.h"
+#include "../include/spdlog/sinks/ringbuffer_sink.h"
+
+using spdlog::sinks::ringbuffer_sink_mt;
+using spdlog::sinks::ringbuffer_sink_st;
+using strings = std::vector<std::string>;
+
+// the message text only, without end of line
+static void set_text_only(spdlog::logger &logger)
+{
+    logger.set_formatter(std::make_shared<spdlog::pattern_formatter>("%v", spdlog::pattern_time_type::local, ""));
+}
+
+TEST_CASE("ringbuffer_sink keeps the last messages", "[ringbuffer_sink]")
+{
+    auto sink = std::make_shared<ringbuffer_sink_st>(3);
+    spdlog::logger logger("ringbuffer", sink);
+    set_text_only(logger);
+    REQUIRE(sink->last_formatted().empty());
+
+    logger.info("1");
+    logger.info("2");
+    REQUIRE((sink->last_formatted() == strings{"1", "2"}));
+    logger.info("3");
+    logger.info("4");
+    logger.info("5");
+    REQUIRE((sink->last_formatted() == strings{"3", "4", "5"}));
+    REQUIRE((sink->last_formatted(2) == strings{"4", "5"}));
+    REQUIRE((sink->last_formatted(10) == strings{"3", "4", "5"}));
+}
+
+TEST_CASE("ringbuffer_sink keeps the last bytes", "[ringbuffer_sink]")
+{
+    auto sink = std::make_shared<ringbuffer_sink_st>(100, 10);
+    spdlog::logger logger("ringbuffer", sink);
+    set_text_only(logger);
+
+    logger.info("aaaa");
+    logger.info("bbbb");
+    REQUIRE((sink->last_formatted() == strings{"aaaa", "bbbb"}));
+    // the text wraps around the end of the buffer
+    logger.info("cccc");
+    REQUIRE((sink->last_formatted() == strings{"bbbb", "cccc"}));
+    logger.info("0123456");
+    REQUIRE((sink->last_formatted() == strings{"0123456"}));
+    for (int i = 0; i < 100; i++)
+    {
+        logger.info("m{}", i % 10);
+        REQUIRE(sink->last_formatted().back() == fmt::format("m{}", i % 10));
+    }
+    REQUIRE((sink->last_formatted() == strings{"m5", "m6", "m7", "m8", "m9"}));
+
+    // messages larger than the buffer are truncated
+    logger.info("0123456789abcdef");
+    REQUIRE((sink->last_formatted() == strings{"0123456789"}));
+    REQUIRE_THROWS_AS(static_cast<void>(ringbuffer_sink_st(0)), const spdlog::spdlog_ex &);
+}
+
+TEST_CASE("ringbuffer_sink snapshots while logging", "[ringbuffer_sink]")
+{
+    auto sink = std::make_shared<ringbuffer_sink_mt>(64, 1024);
+    spdlog::logger logger("ringbuffer", sink);
+    set_text_only(logger);
+    const int messages = 50000;
+
+    std::atomic<bool> done{false};
+    std::thread reader([&]() {
+        while (!done)
+        {
+            // the messages are intact and consecutive
+            auto last = sink->last_formatted();
+            for (size_t i = 0; i < last.size(); i++)
+            {
+                auto n = std::stoi(last[i]);
+                REQUIRE(last[i] == fmt::format("{0} {0} {0}", n));
+                if (i > 0)
+                {
+                    REQUIRE(std::stoi(last[i - 1]) == n - 1);
+                }
+            }
+        }
+    });
+    std::vector<std::thread> writers;
+    std::atomic<int> counter{0};
+    for (int t = 0; t < 2; t++)
+    {
+        writers.emplace_back([&]() {
+            for (int i = 0; i < messages / 2; i++)
+            {
+                // a lock around the counter and the log call keeps the numbers in order in the sink
+                static std::mutex order;
+                std::lock_guard<std::mutex> lock(order);
+                auto n = counter++;
+                logger.info("{0} {0} {0}", n);
+            }
+        });
+    }
+    for (auto &writer : writers)
+    {
+        writer.join();
+    }
+    done = true;
+    reader.join();
+
+    auto last = sink->last_formatted();
+    REQUIRE(!last.empty());
+    REQUIRE(last.back() == fmt::format("{0} {0} {0}", messages - 1));
+}
@@ -0,0 +1,332 @@
+/*
+ * This content is released under the MIT License as specified in https://raw.githubusercontent.com/gabime/spdlog/master/LICENSE
+ */
+#include "includes.h"
+
+#ifndef _WIN32
+
+#include "../include/spdlog/sinks/shm_ring_sink.h"
+
+using spdlog::details::shm_ring;
+using spdlog::sinks::shm_overflow_policy;
+using spdlog::sinks::shm_record_format;
+using spdlog::sinks::shm_ring_sink_st;
+using strings = std::vector<std::string>;
+
+static std::string ring_name()
+{
+    auto name = "/spdlog-test-ring-" + std::to_string(spdlog::details::os::pid());
+    shm_ring::remove(name);
+    return name;
+}
+
+// read all the text records from the ring
+static std::vector<std::string> read_all(shm_ring &ring)
+{
+    std::vector<std::string> records;
+    ring.read([&records](shm_ring::record_type type, const char *data, size_t size) {
+        REQUIRE(type == shm_ring::text);
+        records.emplace_back(data, size);
+    });
+    return records;
+}
+
+static std::string line(const std::string &text)
+{
+    return text + spdlog::details::os::default_eol;
+}
+
+TEST_CASE("shm_ring_sink writes text records", "[shm_ring]")
+{
+    auto name = ring_name();
+    auto sink = std::make_shared<shm_ring_sink_st>(name, 4096);
+    spdlog::logger logger("shm", sink);
+    logger.set_pattern("%v");
+
+    shm_ring reader(name);
+    REQUIRE(read_all(reader).empty());
+    logger.info("Hello {}", 1);
+    logger.info("Hello {}", 2);
+    REQUIRE((read_all(reader) == strings{line("Hello 1"), line("Hello 2")}));
+    REQUIRE(read_all(reader).empty());
+
+    // records wrap around the end of the ring
+    for (int i = 0; i < 1000; i++)
+    {
+        logger.info("message {}", i);
+        REQUIRE((read_all(reader) == strings{line("message " + std::to_string(i))}));
+    }
+    REQUIRE(sink->dropped() == 0);
+    shm_ring::remove(name);
+}
+
+TEST_CASE("shm_ring_sink drops new messages when full", "[shm_ring]")
+{
+    auto name = ring_name();
+    auto sink = std::make_shared<shm_ring_sink_st>(name, 1024, shm_overflow_policy::drop_new);
+    spdlog::logger logger("shm", sink);
+    logger.set_pattern("%v");
+
+    for (int i = 0; i < 100; i++)
+    {
+        logger.info("message {:02d}", i);
+    }
+    shm_ring reader(name);
+    auto records = read_all(reader);
+    REQUIRE(!records.empty());
+    REQUIRE(records.size() < 100);
+    auto total = records.size() + sink->dropped();
+    REQUIRE(total == 100);
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        REQUIRE(records[i] == line(fmt::format("message {:02d}", i)));
+    }
+
+    // room again once read
+    logger.info("after");
+    REQUIRE((read_all(reader) == strings{line("after")}));
+    shm_ring::remove(name);
+}
+
+TEST_CASE("shm_ring_sink overwrites old messages when full", "[shm_ring]")
+{
+    auto name = ring_name();
+    auto sink = std::make_shared<shm_ring_sink_st>(name, 1024, shm_overflow_policy::overwrite_old);
+    spdlog::logger logger("shm", sink);
+    logger.set_pattern("%v");
+
+    for (int i = 0; i < 100; i++)
+    {
+        logger.info("message {:02d}", i);
+    }
+    shm_ring reader(name);
+    auto records = read_all(reader);
+    REQUIRE(!records.empty());
+    auto total = records.size() + sink->dropped();
+    REQUIRE(total == 100);
+    auto first = 100 - records.size();
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        REQUIRE(records[i] == line(fmt::format("message {:02d}", first + i)));
+    }
+    shm_ring::remove(name);
+}
+
+TEST_CASE("shm_ring survives reader and writer restarts", "[shm_ring]")
+{
+    auto name = ring_name();
+    {
+        auto sink = std::make_shared<shm_ring_sink_st>(name, 4096);
+        spdlog::logger logger("shm", sink);
+        logger.set_pattern("%v");
+        logger.info("1");
+        {
+            shm_ring reader(name);
+            REQUIRE((read_all(reader) == strings{line("1")}));
+        }
+        logger.info("2");
+    }
+    // the writer restarted
+    auto sink = std::make_shared<shm_ring_sink_st>(name, 4096);
+    spdlog::logger logger("shm", sink);
+    logger.set_pattern("%v");
+    logger.info("3");
+
+    // the reader restarted: continues after the last record read
+    shm_ring reader(name);
+    REQUIRE((read_all(reader) == strings{line("2"), line("3")}));
+
+    REQUIRE_THROWS_AS(static_cast<void>(shm_ring_sink_st(name, 8192)), const spdlog::spdlog_ex &);
+    shm_ring::remove(name);
+    REQUIRE_THROWS_AS(static_cast<void>(shm_ring(name)), const spdlog::spdlog_ex &);
+}
+
+TEST_CASE("shm_ring writer restarted with another overflow policy", "[shm_ring]")
+{
+    auto name = ring_name();
+    shm_ring reader(name, 1024);
+    {
+        // fill the ring with 48 byte records, then write a 64 byte one at its start: the next position is in the
+        // middle of an older record
+        auto sink = std::make_shared<shm_ring_sink_st>(name, 1024, shm_overflow_policy::drop_new);
+        spdlog::logger logger("shm", sink);
+        logger.set_pattern("%v");
+        for (int i = 0; i < 21; i++)
+        {
+            logger.info(std::string(30 - std::strlen(spdlog::details::os::default_eol), 'a'));
+            REQUIRE(read_all(reader).size() == 1u);
+        }
+        logger.info(std::string(40, 'b'));
+        REQUIRE(read_all(reader).size() == 1u);
+    }
+    auto sink = std::make_shared<shm_ring_sink_st>(name, 1024, shm_overflow_policy::overwrite_old);
+    spdlog::logger logger("shm", sink);
+    logger.set_pattern("%v");
+    for (int i = 0; i < 100; i++)
+    {
+        logger.info("message {:02d}", i);
+    }
+    auto records = read_all(reader);
+    REQUIRE(!records.empty());
+    auto first = 100 - records.size();
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        REQUIRE(records[i] == line(fmt::format("message {:02d}", first + i)));
+    }
+    REQUIRE(sink->dropped() == first);
+    shm_ring::remove(name);
+}
+
+// decode the binary records read from the ring. the sizes of the records read are added to sizes.
+static std::vector<std::string> decode_all(
+    shm_ring &ring, spdlog::sinks::shm_ring_binary_reader &binary, std::vector<size_t> *sizes = nullptr, size_t *skipped = nullptr)
+{
+    spdlog::pattern_formatter formatter("%n %l %v", spdlog::pattern_time_type::local, "");
+    std::vector<std::string> decoded;
+    ring.read([&](shm_ring::record_type type, const char *data, size_t size) {
+        REQUIRE(type == shm_ring::binary);
+        if (sizes != nullptr)
+        {
+            sizes->push_back(size);
+        }
+        auto read = binary.read(data, size, [&](spdlog::details::log_msg &msg) {
+            formatter.format(msg);
+            decoded.push_back(msg.formatted.str());
+        });
+        if (!read && skipped != nullptr)
+        {
+            ++*skipped;
+        }
+    });
+    return decoded;
+}
+
+TEST_CASE("shm_ring_sink writes binary records", "[shm_ring]")
+{
+    auto name = ring_name();
+    auto sink = std::make_shared<shm_ring_sink_st>(name, 4096, shm_overflow_policy::drop_new, shm_record_format::binary);
+    spdlog::logger logger("shm_binary", sink);
+    logger.set_pattern("");
+    logger.info("Hello {} {}", 1, "world");
+    logger.info("Hello {} {}", 2, "world");
+    logger.warn("plain");
+
+    shm_ring reader(name);
+    spdlog::sinks::shm_ring_binary_reader binary;
+    std::vector<size_t> sizes;
+    auto decoded = decode_all(reader, binary, &sizes);
+    REQUIRE((decoded == strings{"shm_binary info Hello 1 world", "shm_binary info Hello 2 world", "shm_binary warning plain"}));
+    // the stream header, the logger name and the format string are written once
+    REQUIRE(sizes.size() == 3u);
+    auto repeated_size = sizes[1] + 20;
+    REQUIRE(repeated_size < sizes[0]);
+    shm_ring::remove(name);
+}
+
+TEST_CASE("shm_ring_sink binary records across generations", "[shm_ring]")
+{
+    auto name = ring_name();
+    auto sink = std::make_shared<shm_ring_sink_st>(name, 1024, shm_overflow_policy::overwrite_old, shm_record_format::binary);
+    spdlog::logger logger("shm_binary", sink);
+    logger.set_pattern("");
+    shm_ring reader(name);
+    spdlog::sinks::shm_ring_binary_reader binary;
+
+    // the ring wraps many times while the reader reads along
+    int next = 0;
+    for (int i = 0; i < 500; i++)
+    {
+        logger.info("message {}", i);
+        if (i % 10 == 9)
+        {
+            for (auto &text : decode_all(reader, binary))
+            {
+                REQUIRE(text == fmt::format("shm_binary info message {}", next++));
+            }
+        }
+    }
+    REQUIRE(next == 500);
+
+    // the reader falls behind: the records whose generation start was overwritten are skipped, the others decoded
+    for (int i = 0; i < 500; i++)
+    {
+        logger.info("later message {}", i);
+    }
+    size_t skipped = 0;
+    auto decoded = decode_all(reader, binary, nullptr, &skipped);
+    REQUIRE(!decoded.empty());
+    REQUIRE(decoded.back() == "shm_binary info later message 499");
+    auto first = 500 - decoded.size();
+    for (size_t i = 0; i < decoded.size(); i++)
+    {
+        REQUIRE(decoded[i] == fmt::format("shm_binary info later message {}", first + i));
+    }
+    auto total = skipped + decoded.size() + sink->dropped();
+    REQUIRE(total == 500u);
+    REQUIRE(skipped > 0u);
+    shm_ring::remove(name);
+}
+
+TEST_CASE("shm_ring_sink binary records after dropped ones", "[shm_ring]")
+{
+    auto name = ring_name();
+    auto sink = std::make_shared<shm_ring_sink_st>(name, 1024, shm_overflow_policy::drop_new, shm_record_format::binary);
+    spdlog::logger logger("shm_binary", sink);
+    logger.set_pattern("");
+    shm_ring reader(name);
+    spdlog::sinks::shm_ring_binary_reader binary;
+
+    for (int i = 0; i < 100; i++)
+    {
+        logger.info("first {}", i);
+    }
+    REQUIRE(sink->dropped() > 0);
+    auto decoded = decode_all(reader, binary);
+    REQUIRE(decoded.size() == 100 - sink->dropped());
+
+    logger.info("second {}", 1);
+    logger.warn("plain");
+    REQUIRE((decode_all(reader, binary) == strings{"shm_binary info second 1", "shm_binary warning plain"}));
+    shm_ring::remove(name);
+}
+
+TEST_CASE("shm_ring concurrent writer and reader", "[shm_ring]")
+{
+    auto name = ring_name();
+    const int messages = 20000;
+    shm_ring writer(name, 2048);
+    shm_ring reader(name);
+
+    std::thread writer_thread([&]() {
+        for (int i = 0; i < messages; i++)
+        {
+            // the number, repeated so torn records would show
+            auto text = fmt::format("{0} {0} {0} {0}", i);
+            writer.write(shm_ring::text, text.data(), text.size(), true);
+        }
+    });
+
+    int last = -1;
+    size_t read = 0;
+    auto check = [&](shm_ring::record_type, const char *data, size_t size) {
+        std::string text(data, size);
+        auto n = std::stoi(text);
+        REQUIRE(text == fmt::format("{0} {0} {0} {0}", n));
+        REQUIRE(n > last);
+        last = n;
+        read++;
+    };
+    while (last < messages - 1)
+    {
+        if (reader.read(check) == 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+    writer_thread.join();
+    auto total = read + writer.dropped();
+    REQUIRE(total == static_cast<size_t>(messages));
+    shm_ring::remove(name);
+}
+
+#endif // _WIN32
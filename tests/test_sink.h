@@ -8,7 +8,9 @@
 #include "spdlog/details/null_mutex.h"
 #include "spdlog/sinks/base_sink.h"
 
+#include <chrono>
 #include <mutex>
+#include <thread>
 
 namespace spdlog {
 namespace sinks {
@@ -27,10 +29,20 @@ public:
         return flushed_msg_counter_;
     }
 
+    // make each message take this long, to stand for a slow sink
+    void set_delay(std::chrono::milliseconds delay)
+    {
+        delay_ = delay;
+    }
+
 protected:
     void _sink_it(const details::log_msg &) override
     {
         msg_counter_++;
+        if (delay_ != std::chrono::milliseconds::zero())
+        {
+            std::this_thread::sleep_for(delay_);
+        }
     }
 
     void _flush() override
@@ -39,6 +51,7 @@ protected:
     }
     size_t msg_counter_{0};
     size_t flushed_msg_counter_{0};
+    std::chrono::milliseconds delay_{std::chrono::milliseconds::zero()};
 };
 
 using test_sink_mt = test_sink<std::mutex>;